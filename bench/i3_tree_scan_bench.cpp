@@ -0,0 +1,92 @@
+// Times findFocusedName() against the QJsonDocument walk it replaced, on a
+// GET_TREE reply. Defaults to the dump in bench/data; pass your own with
+//   i3-msg -t get_tree > tree.json   (or swaymsg -t get_tree -r)
+//   ./i3_tree_scan_bench tree.json [iterations]
+
+#include "i3_tree_scan.hpp"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+#include <algorithm>
+#include <cstdlib>
+#include <print>
+#include <vector>
+
+namespace {
+
+// The DOM path I3Ipc used for GET_TREE before the scanner.
+QString findFocusedWindow(const QJsonObject &node) {
+  if (node["focused"].toBool() && node["type"].toString() != "workspace" &&
+      !node["name"].toString().isEmpty())
+    return node["name"].toString();
+
+  for (const char *key : {"nodes", "floating_nodes"}) {
+    for (const QJsonValue &child : node[key].toArray()) {
+      QString result = findFocusedWindow(child.toObject());
+      if (!result.isEmpty())
+        return result;
+    }
+  }
+  return {};
+}
+
+template <typename Fn> double medianUs(int iterations, Fn &&fn) {
+  std::vector<double> samples;
+  samples.reserve(static_cast<size_t>(iterations));
+  for (int i = 0; i < iterations; ++i) {
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    samples.push_back(static_cast<double>(timer.nsecsElapsed()) / 1000.0);
+  }
+  std::ranges::sort(samples);
+  return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QString path = argc > 1 ? QString::fromLocal8Bit(argv[1])
+                          : QStringLiteral(OBOLC_BENCH_TREE);
+  int iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 200;
+
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    std::println(stderr, "cannot open {}", path.toStdString());
+    return 1;
+  }
+  const QByteArray payload = file.readAll();
+  const std::string_view view(payload.constData(),
+                              static_cast<size_t>(payload.size()));
+
+  // Both must agree before their timings mean anything.
+  QString dom = findFocusedWindow(QJsonDocument::fromJson(payload).object());
+  QString scan = QString::fromStdString(findFocusedName(view));
+  if (dom != scan) {
+    std::println(stderr, "mismatch: dom \"{}\", scan \"{}\"",
+                 dom.toStdString(), scan.toStdString());
+    return 1;
+  }
+
+  QString sink;
+  double domUs = medianUs(iterations, [&] {
+    sink = findFocusedWindow(QJsonDocument::fromJson(payload).object());
+  });
+  double scanUs = medianUs(iterations, [&] {
+    sink = QString::fromStdString(findFocusedName(view));
+  });
+
+  std::println("{} ({} KiB), focused: \"{}\"", path.toStdString(),
+               payload.size() / 1024, scan.toStdString());
+  std::println("  QJsonDocument: {:8.1f} us (median of {})", domUs,
+               iterations);
+  std::println("  scanner:       {:8.1f} us ({:.1f}x)", scanUs,
+               domUs / scanUs);
+  return 0;
+}
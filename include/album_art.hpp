@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QCache>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+class QImageReader;
+class QNetworkAccessManager;
+
+// Album-art thumbnails for mpris:artUrl. Fetching (file:// or http) and
+// decoding happen off the GUI thread, decoding straight to the target size.
+// Ready thumbnails live in a memory LRU keyed by URL and pixel size (plus
+// size and mtime for file:// art), backed by a bounded on-disk cache in
+// ~/.cache/obolc/art.
+class AlbumArt : public QObject {
+  Q_OBJECT
+
+public:
+  explicit AlbumArt(QObject *parent = nullptr);
+
+  // Returns the thumbnail if it is ready. Otherwise returns a null pixmap,
+  // starts loading it, and emits artReady(url) once it can be returned.
+  // A URL that failed to load is not retried until kRetryMs has passed.
+  QPixmap thumbnail(const QString &url, int size, qreal dpr);
+
+signals:
+  void artReady(const QString &url);
+
+private:
+  static constexpr int kMemoryEntries = 64;
+  static constexpr int kDiskEntries = 256;
+  static constexpr int kTransferTimeoutMs = 15000;
+  static constexpr int kRetryMs = 60000;
+
+  QCache<QString, QPixmap> m_cache{kMemoryEntries};
+  QSet<QString> m_pending;
+  QHash<QString, QDeadlineTimer> m_failed; // key -> when to retry
+  QNetworkAccessManager *m_network = nullptr;
+  QString m_diskDir;
+
+  QString diskPath(const QString &key) const;
+  void fetchRemote(const QString &key, const QString &url, int pixelSize,
+                   qreal dpr);
+  void finish(const QString &key, const QString &url, const QImage &image,
+              qreal dpr);
+  static QImage readScaled(QImageReader &reader, int pixelSize);
+  static void storeOnDisk(const QImage &image, const QString &path,
+                          const QString &dir);
+
+  // Declared last so it is destroyed first, joining any running jobs.
+  QThreadPool m_pool;
+};
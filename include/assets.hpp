@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+// Bundled assets (style.css, nix.svg) are compiled into the binary as Qt
+// resources under :/assets. A file of the same name in
+// ~/.config/obolc/assets overrides one; that directory is listed once into
+// a table, so looking an asset up never touches the disk.
+class Assets {
+public:
+  // Where to load name from: the override if there is one, otherwise the
+  // ":/assets/<name>" resource. Empty if neither exists.
+  static QString path(const QString &name);
+
+  // Contents of the asset. Resources are returned without a copy; an
+  // override is read with a single read() sized by fstat(), falling back to
+  // the bundled copy if it cannot be read.
+  static QByteArray read(const QString &name);
+
+  static QString overrideDir();
+
+  // Re-lists the override directory, e.g. after a file was added to it.
+  static void rescan();
+
+private:
+  static QHash<QString, QString> &overrides();
+  static QHash<QString, QString> scan();
+  static QByteArray readResource(const QString &name);
+  static QByteArray readOverride(const QString &path);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QList>
+#include <QWidget>
+
+// Compact strip with one vertical bar per core, painted in the widget's
+// foreground color so it follows the stylesheet like the other labels.
+class CpuBars : public QWidget {
+  Q_OBJECT
+
+public:
+  CpuBars(QWidget *parent = nullptr);
+
+  void setValues(const QList<double> &values);
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+
+private:
+  static constexpr int kBarWidth = 3;
+  static constexpr int kBarGap = 1;
+
+  QList<double> m_values;
+};
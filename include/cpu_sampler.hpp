@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Samples /proc/stat without reopening it or allocating per sample: the fd
+// stays open, each sample is a single pread() into a buffer sized once for
+// the configured core count, and fields are parsed with std::from_chars.
+class CpuSampler {
+public:
+  CpuSampler();
+  ~CpuSampler();
+  CpuSampler(const CpuSampler &) = delete;
+  CpuSampler &operator=(const CpuSampler &) = delete;
+
+  // Returns false if /proc/stat could not be read. Percentages are only
+  // meaningful from the second successful sample on.
+  bool sample();
+
+  double usage() const { return m_usage[0]; }
+  double steal() const { return m_steal; }
+  double guest() const { return m_guest; }
+  std::span<const double> coreUsage() const {
+    return {m_usage.data() + 1, m_usage.size() - 1};
+  }
+
+private:
+  int m_fd = -1;
+  bool m_primed = false;
+  std::vector<char> m_buffer;
+
+  // Struct-of-arrays, slot 0 is the aggregate "cpu" line and slot N+1 is
+  // "cpuN", so the per-core delta loop is branch-free and vectorizes.
+  std::vector<double> m_total, m_idle, m_prevTotal, m_prevIdle, m_usage;
+
+  double m_stealTicks = 0, m_guestTicks = 0;
+  double m_prevStealTicks = 0, m_prevGuestTicks = 0;
+  double m_steal = 0.0, m_guest = 0.0;
+};
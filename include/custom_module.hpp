@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QList>
+#include <QProcess>
+#include <QString>
+#include <QTimer>
+
+// A panel label fed by a user script, declared in
+// ~/.config/obolc/modules.json:
+//
+//   {"modules": [{"name": "lyrics", "exec": "lyrics-line.sh",
+//                 "return-type": "json", "position": "right"},
+//                {"name": "vpn", "exec": "vpn-status", "interval": 10}]}
+//
+// Without "interval" the script is started once and every line it prints
+// replaces the text. With one, it is run on that period, never twice at
+// once. For "return-type": "json" each line is {"text", "tooltip",
+// "class"}; otherwise the line is the text.
+class CustomModule : public QLabel {
+  Q_OBJECT
+
+public:
+  struct Config {
+    QString name;
+    QString exec;
+    int intervalSec = 0; // 0: persistent, streaming script
+    bool json = false;
+    bool left = false;
+  };
+
+  static QList<Config> loadConfig();
+
+  CustomModule(const Config &config, QWidget *parent = nullptr);
+
+  // Runs or schedules the script. Not done in the constructor so that the
+  // panel can paint before any script is forked.
+  void start();
+
+private:
+  static constexpr int kMinRepaintMs = 100;
+  static constexpr int kMaxLineBytes = 64 * 1024;
+  static constexpr int kMinBackoffMs = 1000;
+  static constexpr int kMaxBackoffMs = 60000;
+  static constexpr int kHealthyRunMs = 10000; // resets the backoff
+
+  Config m_config;
+
+  // Streaming mode
+  QProcess *m_process = nullptr;
+  QTimer *m_restartTimer = nullptr;
+  int m_backoffMs = kMinBackoffMs;
+  int m_loggedBackoffMs = 0; // restarts are logged when the delay changes
+  QElapsedTimer m_runTime;    // since the current run was launched
+
+  // Interval mode
+  bool m_inFlight = false;
+
+  // Lines are applied at most every kMinRepaintMs; only the newest counts.
+  QByteArray m_pendingLine;
+  QTimer *m_repaintTimer;
+  QElapsedTimer m_lastRepaint;
+  QString m_class;
+
+  void startStream();
+  void launch();
+  void scheduleRestart();
+  void readStream();
+  void runOnce();
+  void queueLine(const QByteArray &line);
+  void applyLine();
+};
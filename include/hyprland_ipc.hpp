@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QLocalSocket>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+
+// Hyprland backend: follows .socket2.sock events line by line and only uses
+// the .socket.sock request socket for a snapshot whenever events (re)connect.
+class HyprlandIpc : public QObject {
+  Q_OBJECT
+
+public:
+  explicit HyprlandIpc(QObject *parent = nullptr);
+
+  // $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE (or the pre-0.40
+  // /tmp/hypr location). If that instance is gone, e.g. after a compositor
+  // restart, the newest instance with a live socket directory is used.
+  // Empty when no Hyprland instance can be found.
+  static QString socketDir();
+
+  void start(const QString &dir = socketDir());
+
+signals:
+  void workspaceChanged(const QString &workspace);
+  void activeWindowChanged(const QString &title);
+  // Reconnecting kept failing; the compositor is probably gone.
+  void connectionLost();
+
+private:
+  static constexpr int kMaxFailures = 3;
+
+  QString m_dir;
+  int m_failures = 0;
+  QLocalSocket *m_events;
+  QTimer *m_reconnectTimer;
+  QByteArray m_buffer;
+  QString m_workspaceId;
+  QString m_workspace;
+  QString m_title;
+
+  void connectEvents();
+  void readEvents();
+  void handleEvent(QByteArrayView name, QByteArrayView data);
+  void requestSnapshot();
+  void requestWorkspace();
+  void request(const QByteArray &command,
+               std::function<void(const QByteArray &)> onReply);
+  void setWorkspace(const QString &id, const QString &name);
+  void setTitle(const QString &title);
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <cstdint>
+
+// i3-ipc client shared by i3 and Sway. Speaks the binary protocol
+// ("i3-ipc" magic, u32 length, u32 type) over $I3SOCK/$SWAYSOCK, subscribes
+// to workspace and window events and keeps focus state from their payloads.
+// GET_TREE is only used to resynchronize after (re)connecting.
+class I3Ipc : public QObject {
+  Q_OBJECT
+
+public:
+  explicit I3Ipc(QObject *parent = nullptr);
+
+  // $SWAYSOCK or $I3SOCK, whichever is set; empty otherwise.
+  static QString socketPath();
+
+  void start(const QString &path = socketPath());
+
+signals:
+  void workspaceChanged(const QString &workspace);
+  void activeWindowChanged(const QString &title);
+  // Reconnecting kept failing; the window manager is probably gone.
+  void connectionLost();
+
+private:
+  enum MessageType : uint32_t {
+    GetWorkspaces = 1,
+    Subscribe = 2,
+    GetTree = 4,
+  };
+  static constexpr uint32_t kEventBit = 0x80000000;
+  static constexpr uint32_t kWorkspaceEvent = kEventBit | 0;
+  static constexpr uint32_t kWindowEvent = kEventBit | 3;
+  static constexpr int kMaxFailures = 3;
+
+  QString m_path;
+  int m_failures = 0;
+  QLocalSocket *m_socket;
+  QTimer *m_reconnectTimer;
+  QByteArray m_buffer;
+  QString m_workspace;
+  QString m_title;
+
+  void connectSocket();
+  void onConnected();
+  void readMessages();
+  void send(uint32_t type, const QByteArray &payload = {});
+  void handleMessage(uint32_t type, const QByteArray &payload);
+  void handleWorkspaceEvent(const QJsonObject &event);
+  void handleWindowEvent(const QJsonObject &event);
+  static QString findFocusedWindow(const QJsonObject &node);
+  void setWorkspace(const QString &workspace);
+  void setTitle(const QString &title);
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Streaming scan of an i3/Sway GET_TREE reply for the focused container's
+// name. Walks the JSON text once without building a DOM or copying subtrees;
+// only the winning name is unescaped. Returns an empty string if nothing
+// (other than a workspace) has focus or the input is malformed.
+std::string findFocusedName(std::string_view json);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QCache>
+#include <QColor>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+class QImageReader;
+
+// Process-wide icon rasters, one per (source, size, DPR, tint). Sources
+// are files or resources (SVG or bitmap), rasterized on a worker thread
+// straight to the target size, or icon theme names, which QIcon renders on
+// the GUI thread. Rasters live in an LRU bounded by bytes and, unless
+// OBOLC_ICON_DISK_CACHE=0, as PNGs in ~/.cache/obolc/icons so a restart
+// skips SVG parsing.
+class IconCache : public QObject {
+  Q_OBJECT
+
+public:
+  // Lives on the GUI thread and is owned by the application.
+  static IconCache *instance();
+
+  // Returns the raster if it is ready. Otherwise returns a null pixmap,
+  // starts rendering it, and emits iconReady(source) once it can be
+  // returned. An invalid tint keeps the icon's own colors.
+  QPixmap pixmap(const QString &source, int size, qreal dpr,
+                 const QColor &tint = {});
+
+signals:
+  void iconReady(const QString &source);
+
+private:
+  static constexpr int kMemoryKiB = 4 * 1024;
+  static constexpr int kDiskEntries = 256;
+
+  explicit IconCache(QObject *parent);
+
+  QCache<QString, QPixmap> m_cache{kMemoryKiB}; // cost: KiB of pixels
+  QSet<QString> m_pending;
+  QString m_diskDir; // empty: disk cache disabled
+
+  QString diskPath(const QString &source, int pixelSize,
+                   const QColor &tint) const;
+  static QString fileVersion(const QString &source);
+  void finish(const QString &key, const QString &source, const QImage &image,
+              qreal dpr);
+  static QImage render(const QString &source, int pixelSize,
+                       const QColor &tint);
+  static void storeOnDisk(const QImage &image, const QString &path,
+                          const QString &dir);
+
+  // Declared last so it is destroyed first, joining any running jobs.
+  QThreadPool m_pool;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QCache>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+
+#include "mpris.hpp"
+
+struct LyricLine {
+  qint64 timeMs;
+  QString text;
+};
+
+// Sorted by timeMs; an empty list caches "no lyrics for this track".
+using LyricsTrack = QList<LyricLine>;
+
+// Time-indexed LRC lyrics for one MPRIS player. The current line is found by
+// binary search on the extrapolated position, and the next update is armed
+// for the exact next line boundary.
+class Lyrics : public QObject {
+  Q_OBJECT
+
+public:
+  explicit Lyrics(Mpris *mpris, QObject *parent = nullptr);
+
+  void setPlayer(const QString &playerName);
+  QString currentLine() const { return m_currentLine; }
+
+  static LyricsTrack parseLrc(const QString &content);
+
+signals:
+  void currentLineChanged(const QString &line);
+
+private slots:
+  void refresh();
+
+private:
+  Mpris *m_mpris;
+  QString m_player;
+  QString m_currentLine;
+  QTimer *m_timer;
+  QCache<QString, LyricsTrack> m_cache{32};
+
+  const LyricsTrack *trackLyrics(const QVariantMap &metadata);
+  static QString findLrcFile(const QVariantMap &metadata);
+  static QString trackKey(const QVariantMap &metadata);
+  void setLine(const QString &line);
+};
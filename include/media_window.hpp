@@ -1,75 +1,109 @@
 #pragma once
-#include <QApplication>
-#include <QDateTime>
-#include <QFile>
 #include <QFrame>
-#include <QGraphicsScene>
-#include <QHBoxLayout>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QLabel>
-#include <QMessageBox>
-#include <QProcess>
-#include <QProgressBar>
+#include <QListView>
+#include <QPersistentModelIndex>
 #include <QPushButton>
-#include <QRegularExpression>
-#include <QScreen>
-#include <QScrollArea>
-#include <QTextStream>
-#include <QTimer>
-#include <QVBoxLayout>
+#include <QString>
+#include <QStyledItemDelegate>
 #include <QWidget>
-#include <QWindow>
 
-class PlayerWidget : public QFrame {
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "album_art.hpp"
+#include "mpris.hpp"
+#include "player_list_model.hpp"
+
+// Transport buttons of a player row, left to right, top row first.
+enum class Control : uint8_t {
+  SeekBack,
+  Previous,
+  PlayPause,
+  Next,
+  SeekForward,
+  Loop,
+  Shuffle,
+  Count,
+};
+
+// The real buttons of one row. Only the row under the pointer has them;
+// every other row's controls are painted by PlayerDelegate.
+class PlayerControls : public QWidget {
   Q_OBJECT
 public:
-  PlayerWidget(const QString &playerName, QWidget *parent = nullptr);
-  void updatePlayerData(const QString &title, const QString &artist,
-                        int position, int length, const QString &albumArtPath);
+  PlayerControls(const QString &playerName, Mpris *mpris,
+                 QWidget *parent = nullptr);
   QString getPlayerName() const { return m_playerName; }
 
+protected:
+  void resizeEvent(QResizeEvent *event) override;
+
 private:
   QString m_playerName;
-  QLabel *m_titleLabel;
-  QLabel *m_artistLabel;
-  QLabel *m_playerNameLabel;
-  QProgressBar *m_progressBar;
-  QPixmap m_albumArtPix;
-  QLabel *m_albumArt;
-
-  QPushButton *m_seekBackBtn;
-  QPushButton *m_prevBtn;
-  QPushButton *m_playPauseBtn;
-  QPushButton *m_nextBtn;
-  QPushButton *m_seekFwdBtn;
-  QPushButton *m_loopBtn;
-  QPushButton *m_shuffleBtn;
+  Mpris *m_mpris;
+  std::array<QPushButton *, static_cast<size_t>(Control::Count)> m_buttons;
+
+  QPushButton *button(Control control) const {
+    return m_buttons[static_cast<size_t>(control)];
+  }
 
-  void setupUI();
   void setupControls();
+  void updatePlayerState();
+};
+
+// Paints a whole player row (frame, art, text, progress and controls) from
+// the model, so rows cost no widgets until they are hovered.
+class PlayerDelegate : public QStyledItemDelegate {
+  Q_OBJECT
+public:
+  // Style probes are created as hidden children of parent, normally the view.
+  PlayerDelegate(Mpris *mpris, AlbumArt *albumArt, QWidget *parent);
+
+  void paint(QPainter *painter, const QStyleOptionViewItem &option,
+             const QModelIndex &index) const override;
+  QSize sizeHint(const QStyleOptionViewItem &option,
+                 const QModelIndex &index) const override;
+
+  QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                        const QModelIndex &index) const override;
+  void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+  void setModelData(QWidget *editor, QAbstractItemModel *model,
+                    const QModelIndex &index) const override;
+  void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
+                            const QModelIndex &index) const override;
+
+private:
+  Mpris *m_mpris;
+  AlbumArt *m_albumArt;
+  QFrame *m_frame;
+  QFrame *m_name;
+  QFrame *m_title;
+  QFrame *m_artist;
+
+  void paintControls(QPainter *painter, const QStyleOptionViewItem &option,
+                     const QModelIndex &index, const QRect &area) const;
 };
 
+// Built on first open through a Popup. While hidden it holds no Mpris
+// subscriptions and no ticks; showing it catches the model up first.
 class MediaWindow : public QWidget {
   Q_OBJECT
 public:
-  MediaWindow(QWidget *parent = nullptr);
+  MediaWindow(Mpris *mpris, QWidget *parent = nullptr);
 
 private:
-  QScrollArea *m_scrollArea;
-  QWidget *m_scrollContent;
-  QVBoxLayout *m_scrollLayout;
-  QList<PlayerWidget *> m_playerWidgets;
+  Mpris *m_mpris;
+  AlbumArt *m_albumArt;
+  PlayerListModel *m_model;
+  QListView *m_view;
+  QPersistentModelIndex m_controlsIndex;
 
   void setupWindow();
   void setupUI();
-  PlayerWidget *findOrCreatePlayerWidget(const QString &playerName);
-  void removeUnusedPlayerWidgets(const QStringList &activePlayerNames);
-
-private slots:
-  void updateData();
+  void showControls(const QModelIndex &index);
 
 protected:
   void showEvent(QShowEvent *event) override;
+  void hideEvent(QHideEvent *event) override;
 };
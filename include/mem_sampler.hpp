@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// The /proc/meminfo fields we care about, in kB. Everything else in the file
+// is skipped without being looked at twice.
+enum class MemKey : uint8_t {
+  MemTotal,
+  MemFree,
+  MemAvailable,
+  Buffers,
+  Cached,
+  SwapCached,
+  SwapTotal,
+  SwapFree,
+  Zswap,
+  Zswapped,
+  Dirty,
+  Writeback,
+  Shmem,
+  Count,
+};
+
+struct MemInfo {
+  std::array<uint64_t, static_cast<size_t>(MemKey::Count)> kb{};
+
+  uint64_t operator[](MemKey key) const {
+    return kb[static_cast<size_t>(key)];
+  }
+};
+
+// Samples /proc/meminfo through a persistent fd and a fixed buffer; a sample
+// is one pread() and a single pass over the text, with no allocations.
+class MemSampler {
+public:
+  MemSampler();
+  ~MemSampler();
+  MemSampler(const MemSampler &) = delete;
+  MemSampler &operator=(const MemSampler &) = delete;
+
+  // Returns false if /proc/meminfo could not be read.
+  bool sample();
+
+  const MemInfo &info() const { return m_info; }
+
+private:
+  int m_fd = -1;
+  std::array<char, 8192> m_buffer;
+  MemInfo m_info;
+};
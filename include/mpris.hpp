@@ -1,17 +1,59 @@
 #pragma once
 
 #include <QDBusConnection>
-#include <QDBusInterface>
+#include <QDBusMessage>
+#include <QDBusServiceWatcher>
+#include <QDBusVariant>
+#include <QHash>
 #include <QObject>
 #include <QStringList>
-#include <QTimer>
 #include <QVariantMap>
 
+#include <algorithm>
+#include <chrono>
 #include <optional>
 
 struct PlayerData {
   QString title, artist;
-  int32_t position, length;
+  int32_t position, length; // seconds
+  QString artUrl;
+};
+
+// Cached view of a player's org.mpris.MediaPlayer2.Player properties, kept
+// current from PropertiesChanged instead of being queried on demand.
+struct PlayerState {
+  QString owner; // unique bus name, used to match signal senders
+  QVariantMap metadata;
+  QString playbackStatus = "Stopped";
+  double rate = 1.0;
+  QString loopStatus = "None";
+  bool shuffle = false;
+  quint64 lastPlayedSeq = 0; // order of the latest switch to Playing
+
+  // Position is sampled once and extrapolated from a monotonic clock; it is
+  // re-anchored on Seeked, track changes and status/rate changes only.
+  qint64 anchorPositionUs = 0;
+  std::chrono::steady_clock::time_point anchorTime =
+      std::chrono::steady_clock::now();
+
+  qint64 lengthUs() const {
+    return metadata.value("mpris:length").toLongLong();
+  }
+
+  qint64 positionUs(std::chrono::steady_clock::time_point now =
+                        std::chrono::steady_clock::now()) const {
+    qint64 pos = anchorPositionUs;
+    if (playbackStatus == "Playing") {
+      auto elapsed =
+          std::chrono::duration_cast<std::chrono::microseconds>(now -
+                                                                anchorTime);
+      pos += static_cast<qint64>(static_cast<double>(elapsed.count()) * rate);
+    }
+    qint64 length = lengthUs();
+    if (length > 0)
+      pos = std::min(pos, length);
+    return std::max<qint64>(pos, 0);
+  }
 };
 
 class Mpris : public QObject {
@@ -22,29 +64,88 @@ public:
   ~Mpris();
 
   QStringList getPlayers() const { return activePlayers; }
-  QVariantMap getPlayerMetadata(const QString &playerName);
-  void startMonitoring(int intervalMs = 5000);
+  QVariantMap getPlayerMetadata(const QString &playerName) const;
+  std::optional<PlayerState> getPlayerState(const QString &playerName) const;
+  PlayerData getPlayerData(const QString &player) const;
+  qint64 getPosition(const QString &player) const;
+  void startMonitoring();
   void stopMonitoring();
   void cleanup();
 
-  std::optional<QString> getLyrics();
+  // Accepts either a full bus name or a playerctl-style short name.
+  static QString busName(const QString &player);
+  static QString shortName(const QString &player);
+
+  // Transport controls. Calls are asynchronous; toggles update the model
+  // optimistically and roll back if the player rejects the call.
+  void playPause(const QString &player);
+  void next(const QString &player);
+  void previous(const QString &player);
+  void seek(const QString &player, qint64 offsetUs);
+  void setPosition(const QString &player, qint64 positionUs);
+  void setLoopStatus(const QString &player, const QString &status);
+  void setShuffle(const QString &player, bool shuffle);
+
+  // Focus policy: a pinned player wins outright; otherwise playing beats
+  // paused, then the priority prefix list, then whoever started playing
+  // most recently. Re-evaluated from signals, never on a timer.
+  QString activePlayer() const { return m_activePlayer; }
+  void setPlayerPriority(const QStringList &prefixes);
+  void setPinnedPlayer(const QString &player);
+
+  // Applies ~/.config/obolc/mpris.json if present:
+  //   {"priority": ["spotify", "firefox"], "pinned": "mpv"}
+  // Missing keys keep the built-in defaults.
+  void loadPolicy();
 
 public slots:
   void updatePlayers();
 
-  static std::optional<QString> getCurrentLyrics();
-  static PlayerData getPlayerData(const QString &identity);
-
 signals:
   void playersChanged(const QStringList &players);
   void playerMetadataChanged(const QString &playerName,
                              const QVariantMap &metadata);
+  void playerStateChanged(const QString &playerName);
+  void playerPositionChanged(const QString &playerName, qint64 positionUs);
+  void activePlayerChanged(const QString &playerName);
+
+private slots:
+  void onServiceOwnerChanged(const QString &service, const QString &oldOwner,
+                             const QString &newOwner);
+  void onPropertiesChanged(const QString &interface,
+                           const QVariantMap &changed,
+                           const QStringList &invalidated,
+                           const QDBusMessage &message);
+  void onSeeked(qlonglong positionUs, const QDBusMessage &message);
 
 private:
-  static QDBusInterface *dbusIface;
-  static QTimer *timer;
-  static QStringList activePlayers;
+  QDBusServiceWatcher *m_watcher = nullptr;
+  QStringList activePlayers;
+  QHash<QString, PlayerState> m_players;
+  QMultiHash<QString, QString> m_playersByOwner; // unique name -> players
+  bool m_monitoring = false;
+
+  QStringList m_priority = {"spotifyd", "spotify_player", "spotify",
+                            "firefox", "chrome"};
+  QString m_pinnedPlayer;
+  QString m_activePlayer;
+  quint64 m_playSequence = 0;
 
   void initializeDBus();
-  QStringList fetchActivePlayersFromDBus();
+  void addPlayer(const QString &playerName, const QString &owner);
+  void removePlayer(const QString &playerName);
+  void fetchPlayerProperties(const QString &playerName);
+  void fetchPosition(const QString &playerName);
+  void anchorPosition(const QString &playerName, qint64 positionUs);
+  void updateActivePlayer();
+  void applyProperties(const QString &playerName, const QVariantMap &props);
+  QStringList playersForOwner(const QString &owner) const;
+  void setOwner(const QString &playerName, const QString &owner);
+  void callPlayer(const QString &playerName, const QString &method,
+                  const QVariantList &args = {},
+                  const QVariantMap &rollback = {});
+  void setPlayerProperty(const QString &playerName, const QString &property,
+                         const QVariant &value);
+  void sendAsync(const QDBusMessage &msg, const QString &playerName,
+                 const QVariantMap &rollback);
 };
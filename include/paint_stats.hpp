@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QWidget>
+
+// Debug counters for a widget tree: layout passes and repainted device
+// pixels, so a change that makes the whole bar repaint every tick shows up
+// as a number instead of as compositor load.
+class PaintStats : public QObject {
+  Q_OBJECT
+
+public:
+  explicit PaintStats(QObject *parent = nullptr);
+
+  // Watches root and every descendant, including ones added later.
+  void watch(QWidget *root);
+
+  // "N relayouts/s, M px/s" averaged since the previous call.
+  QString sample();
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  quint64 m_relayouts = 0;
+  quint64 m_pixels = 0;
+  QElapsedTimer m_window;
+};
@@ -18,43 +18,70 @@
 #include <QWidget>
 #include <QWindow>
 
-#include "media_window.hpp"
+#include <array>
+
+#include "cpu_bars.hpp"
+#include "custom_module.hpp"
+#include "lyrics.hpp"
 #include "mpris.hpp"
+#include "paint_stats.hpp"
+#include "popup.hpp"
+#include "segment_bar.hpp"
 #include "system_info.hpp"
 #include "tray.hpp"
 
+// Widgets: one styled QLabel/QPushButton per segment. Painted: a single
+// SegmentBar draws them all (--painted).
+enum class PanelRenderer : uint8_t { Widgets, Painted };
+
 class Panel : public QWidget {
   Q_OBJECT
 
   uint8_t m_panelHeight = 42;
+  static constexpr int kStartIconSize = 16;
 
 public:
-  Panel(QWidget *parent = nullptr);
-  void setupMediaWindow(MediaWindow *mediaWindow);
+  Panel(PanelRenderer renderer = PanelRenderer::Widgets,
+        QWidget *parent = nullptr);
+  void setupMediaWindow(Popup *mediaWindow);
   void setupMpris(Mpris *mpris);
-  MediaWindow *m_mediaWindow;
-  Mpris *m_mpris;
+  Popup *m_mediaWindow = nullptr;
+  Mpris *m_mpris = nullptr;
   void onMediaClicked();
 
+signals:
+  // Emitted once, right after the panel is first on screen. Startup work
+  // that the first frame does not need waits for this.
+  void firstFramePainted();
+
 private:
+  PanelRenderer m_renderer;
+  bool m_painted = false;
   SystemMonitor *m_systemMonitor;
-  QLabel *m_timeLabel;
-  QLabel *m_dateLabel;
-  QLabel *m_workspaceLabel;
-  QLabel *m_windowLabel;
-  QLabel *m_cpuLabel;
-  QLabel *m_memoryLabel;
-  QLabel *m_swapLabel;
-  QPushButton *m_mediaBtn;
-  QPushButton *m_menuButton;
-  QTimer *m_clockTimer;
+  std::shared_ptr<const SystemInfo> m_lastInfo;
+
+  // Widget renderer: one widget per segment. Painted renderer: m_bar only.
+  std::array<QWidget *, static_cast<size_t>(Segment::Count)> m_segments{};
+  CpuBars *m_cpuBars = nullptr;
+  SegmentBar *m_bar = nullptr;
 
   Tray *m_tray;
+  Lyrics *m_lyrics = nullptr;
+  PaintStats *m_paintStats;
+
+  QWidget *&segment(Segment s) { return m_segments[static_cast<size_t>(s)]; }
 
   void setupWindow();
   void setupUI();
+  void setupWidgetUI(QHBoxLayout *layout);
+  void setupPaintedUI(QHBoxLayout *layout);
   void setupTimer();
-  void setupMedia();
+  void reserveNumericWidths();
+  void setSegmentText(Segment s, const QString &text);
+  void setSegmentToolTip(Segment s, const QString &text);
+  void setSegmentVisible(Segment s, bool visible);
+  void onFirstFrame();
+  void updateStartIcon();
 
 private slots:
   void updateTime();
@@ -64,6 +91,9 @@ private slots:
 
 protected:
   void showEvent(QShowEvent *event) override;
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void changeEvent(QEvent *event) override;
 };
 
 // #include "panel.moc"
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QString>
+#include <QStringList>
+
+#include "mpris.hpp"
+
+// One row per MPRIS player, active player first, kept current from Mpris
+// signals. Rows are found through a name -> row hash, and each kind of
+// change is reported with only the roles it touches, so a position tick
+// repaints progress and nothing else.
+class PlayerListModel : public QAbstractListModel {
+  Q_OBJECT
+
+public:
+  enum Role {
+    NameRole = Qt::UserRole + 1, // full bus name
+    TitleRole,
+    ArtistRole,
+    ArtUrlRole,
+    PositionRole, // seconds
+    LengthRole,   // seconds
+    StatusRole,
+    LoopRole,
+    ShuffleRole,
+  };
+
+  // Rows are filled from Mpris' cached state right away, so a view built
+  // on a fresh model shows the current players on its first frame.
+  explicit PlayerListModel(Mpris *mpris, QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = {}) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  QHash<int, QByteArray> roleNames() const override;
+
+  int rowOf(const QString &player) const { return m_index.value(player, -1); }
+
+  // Re-reads the extrapolated position of playing players; emits only for
+  // rows whose displayed second moved.
+  void refreshPositions();
+  // Album art for url finished loading.
+  void artReady(const QString &url);
+
+  // While inactive the model drops its Mpris subscriptions; reactivating
+  // re-reads every player and reports only what changed meanwhile.
+  void setActive(bool active);
+
+private:
+  struct Row {
+    QString name;
+    QString title;
+    QString artist;
+    QString artUrl;
+    int position = 0;
+    int length = 0;
+    QString status;
+    QString loop;
+    bool shuffle = false;
+  };
+
+  Mpris *m_mpris;
+  QList<Row> m_rows;
+  QHash<QString, int> m_index;
+  QList<QMetaObject::Connection> m_connections;
+
+  void subscribe();
+
+  void syncPlayers(const QStringList &players);
+  void updateMetadata(const QString &player);
+  void updateState(const QString &player);
+  void updatePosition(const QString &player);
+  void moveToTop(const QString &player);
+  void reindex(int from);
+  void emitRowChanged(int row, const QList<int> &roles);
+
+  bool readMetadata(Row &row) const;
+  bool readState(Row &row) const;
+  bool readPosition(Row &row) const;
+};
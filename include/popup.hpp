@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+#include <functional>
+
+// Holds a popup window that is only built the first time it is opened. Once
+// it has stayed hidden for the idle period it is destroyed again, taking its
+// child widgets, pixmaps and subscriptions with it, and the next open builds
+// a fresh one. Popups are expected to fill themselves from models that are
+// kept current elsewhere, so a rebuilt popup is correct on its first frame.
+class Popup : public QObject {
+  Q_OBJECT
+
+public:
+  using Factory = std::function<QWidget *()>;
+
+  explicit Popup(Factory factory, QObject *parent = nullptr);
+  ~Popup() override;
+
+  bool isVisible() const { return m_widget && m_widget->isVisible(); }
+  void show();
+  void hide();
+  void toggle();
+
+  // OBOLC_POPUP_IDLE_SEC, default 300. 0 releases a popup as soon as it is
+  // hidden; a negative value keeps it for the rest of the session.
+  static int idleSeconds();
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  static constexpr int kDefaultIdleSec = 300;
+
+  Factory m_factory;
+  QPointer<QWidget> m_widget;
+  QTimer *m_idle;
+
+  void release();
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+struct ProcessResult {
+  int exitCode = -1;
+  bool timedOut = false;
+  bool failedToStart = false;
+  QByteArray stdOut;
+
+  bool ok() const { return !timedOut && !failedToStart && exitCode == 0; }
+};
+
+// Runs external commands without ever blocking the caller. Identical argv
+// lines in flight share one child, finished results can be kept for a TTL,
+// every child has a deadline after which it is killed, and at most
+// kMaxConcurrent children run at once; the rest wait in a queue.
+class ProcessRunner : public QObject {
+  Q_OBJECT
+
+public:
+  struct Options {
+    int timeoutMs = 5000;
+    int cacheTtlMs = 0; // 0: do not cache
+  };
+
+  using Callback = std::function<void(const ProcessResult &)>;
+
+  // Lives on the GUI thread and is owned by the application.
+  static ProcessRunner *instance();
+
+  // onDone runs on the GUI thread, and not at all if context is destroyed
+  // first. It may run before run() returns when the result is cached.
+  void run(const QString &program, const QStringList &args, QObject *context,
+           Callback onDone, Options options);
+  void run(const QString &program, const QStringList &args, QObject *context,
+           Callback onDone) {
+    run(program, args, context, std::move(onDone), Options());
+  }
+
+  // Spawn, coalescing, cache and latency counters, one per line.
+  QStringList stats() const;
+
+private:
+  static constexpr int kMaxConcurrent = 4;
+
+  struct Waiter {
+    QPointer<QObject> context;
+    Callback onDone;
+  };
+
+  struct Job {
+    QString program;
+    QStringList args;
+    Options options;
+    QList<Waiter> waiters;
+    QProcess *process = nullptr;
+    QElapsedTimer started;
+    bool timedOut = false;
+  };
+
+  struct CacheEntry {
+    ProcessResult result;
+    QElapsedTimer age;
+    int ttlMs;
+  };
+
+  explicit ProcessRunner(QObject *parent);
+
+  QHash<QString, Job> m_jobs;
+  QQueue<QString> m_queue;
+  QHash<QString, CacheEntry> m_cache;
+  int m_running = 0;
+
+  quint64 m_spawned = 0;
+  quint64 m_coalesced = 0;
+  quint64 m_cacheHits = 0;
+  quint64 m_timedOut = 0;
+  quint64 m_failed = 0;
+  qint64 m_totalLatencyMs = 0;
+  qint64 m_maxLatencyMs = 0;
+
+  static QString jobKey(const QString &program, const QStringList &args);
+  void startQueued();
+  void spawn(const QString &key);
+  void finish(const QString &key, ProcessResult result);
+  void pruneCache();
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QColor>
+#include <QFont>
+#include <QIcon>
+#include <QList>
+#include <QMargins>
+#include <QRect>
+#include <QSize>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+#include <array>
+#include <cstdint>
+
+// The panel's built-in segments, in left-to-right order within each group.
+enum class Segment : uint8_t {
+  Start,
+  Workspace,
+  Window,
+  Media,
+  Cpu,
+  CpuBars,
+  Memory,
+  Swap,
+  Date,
+  Time,
+  Count,
+};
+
+// Alternative to the panel's label widgets: one widget that lays out and
+// paints every segment itself. Each segment keeps a hidden probe widget of
+// the type and class the widget renderer would use; colors, fonts, box
+// insets and backgrounds (including :hover and user overrides) are taken
+// from the stylesheet through it, so both renderers look the same.
+// Label text is kept as prepared QStaticText, so a tick that changes one
+// value repaints that segment's rect and nothing else, and a relayout only
+// happens when a segment actually changes width.
+class SegmentBar : public QWidget {
+  Q_OBJECT
+
+public:
+  explicit SegmentBar(QWidget *parent = nullptr);
+
+  void setText(Segment segment, const QString &text);
+  void setSegmentToolTip(Segment segment, const QString &text);
+  void setSegmentVisible(Segment segment, bool visible);
+  void setIcon(Segment segment, const QIcon &icon);
+  void setBars(const QList<double> &values);
+
+  // Keeps the segment at least as wide as text, right-aligning its content.
+  void reserveWidth(Segment segment, const QString &widest);
+  QFontMetrics segmentFontMetrics(Segment segment) const;
+
+signals:
+  void clicked(Segment segment);
+
+protected:
+  bool event(QEvent *event) override;
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void changeEvent(QEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseReleaseEvent(QMouseEvent *event) override;
+  void leaveEvent(QEvent *event) override;
+
+private:
+  static constexpr int kEdge = 8;    // layout contents margin
+  static constexpr int kSpacing = 6; // layout spacing
+  static constexpr int kBarWidth = 3;
+  static constexpr int kBarGap = 1;
+
+  struct Item {
+    QWidget *probe = nullptr; // QPushButton for buttons, QLabel otherwise
+    QString text;
+    QStaticText staticText;
+    QString toolTip;
+    QIcon icon;
+    bool visible = true;
+    QString reservedText;
+    int reservedWidth = 0;
+    int contentWidth = 0;
+    QRect box; // widget rect, stylesheet margins included
+
+    // Read from the probe by loadStyle().
+    QFont font;
+    QColor color;
+    QMargins insets; // margin + border + padding
+    int maxWidth = QWIDGETSIZE_MAX;
+  };
+
+  std::array<Item, static_cast<size_t>(Segment::Count)> m_items;
+  QList<double> m_bars;
+  Segment m_hovered = Segment::Count;
+  Segment m_pressed = Segment::Count;
+
+  Item &item(Segment segment) {
+    return m_items[static_cast<size_t>(segment)];
+  }
+  const Item &item(Segment segment) const {
+    return m_items[static_cast<size_t>(segment)];
+  }
+
+  static bool isButton(Segment segment);
+  void createProbes();
+  void reloadStyles();
+  void loadStyle(Segment segment);
+  void prepareText(Segment segment);
+  int measure(Segment segment) const;
+  void relayout();
+  Segment segmentAt(const QPoint &pos) const;
+  void setHovered(Segment segment);
+  void paintSegment(QPainter &painter, Segment segment);
+  void paintButton(QPainter &painter, Segment segment);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+
+// --trace-startup: records startup phases as Chrome trace events (open the
+// file in chrome://tracing or ui.perfetto.dev). Timestamps are CLOCK_BOOTTIME
+// microseconds, the clock /proc uses for process start, so the time spent
+// before main() shows up as its own span. When tracing is off every call is
+// a single relaxed load.
+class StartupTrace {
+public:
+  // Starts recording; the file is written a few seconds after firstFrame().
+  static void enable(const QString &path);
+  static bool enabled();
+
+  // Marks a point in time, e.g. the first frame or a reply arriving.
+  static void instant(const char *name);
+
+  // The panel has been painted once. Schedules writing the trace, leaving
+  // time for the work deferred past the first frame to show up in it.
+  static void firstFrame();
+
+  // Records the time between construction and end() (or destruction) as a
+  // complete event on the calling thread. Safe to use from any thread.
+  class Span {
+  public:
+    explicit Span(const char *name);
+    ~Span() { end(); }
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+    void end();
+
+  private:
+    const char *m_name;
+    int64_t m_startUs = -1; // -1: tracing off or already ended
+  };
+
+private:
+  static constexpr int kSettleMs = 3000;
+
+  static int64_t nowUs();
+  static void record(const char *name, char phase, int64_t startUs,
+                     int64_t durationUs);
+  static void write();
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "cpu_sampler.hpp"
+#include "mem_sampler.hpp"
+
+class HyprlandIpc;
+class I3Ipc;
+
+enum class WindowManager : uint8_t { Unknown, I3, Hyprland, Sway, Other };
+
+// One published state of the system. Never modified once published; every
+// change produces a new snapshot with a higher generation.
+struct SystemInfo {
+  quint64 generation = 0;
+  WindowManager windowManager = WindowManager::Unknown;
+  double cpuUsage = 0.0;
+  double cpuSteal = 0.0;
+  double cpuGuest = 0.0;
+  QList<double> coreUsage;
+  double memoryUsage = 0.0;
+  double swapUsage = 0.0;
+  MemInfo memInfo;
+  QString currentWindow;
+  QString currentWorkspace;
+};
+
+// Does all sampling on the thread it is moved to: /proc reads on a timer and
+// the window-manager IPC sockets in that thread's event loop. Readers on any
+// thread take the latest snapshot without locking and without copying the
+// strings inside: snapshots are double-buffered shared_ptrs, and the
+// collector only refills the slot readers are not pointed at once no reader
+// is still copying it. Readers never wait; only plain atomic integers are
+// used, which are lock-free on every standard library.
+class SystemCollector : public QObject {
+  Q_OBJECT
+
+public:
+  explicit SystemCollector(QObject *parent = nullptr);
+
+  std::shared_ptr<const SystemInfo> snapshot() const;
+
+  // published() is not emitted again until the reader acknowledges, so a
+  // busy UI thread sees one queued notification instead of a backlog. Call
+  // before reading the snapshot.
+  void acknowledge();
+
+public slots:
+  // Runs on the collector thread once it has started.
+  void start();
+  // Takes a fresh CPU and memory sample and publishes it.
+  void updateSystemInfo();
+
+signals:
+  void published();
+
+private slots:
+  void onWorkspaceChanged(const QString &workspace);
+  void onActiveWindowChanged(const QString &title);
+  void redetectWindowManager();
+
+private:
+  static constexpr int kMinRedetectMs = 1000;
+  static constexpr int kMaxRedetectMs = 60000;
+
+  // Working copy, only touched on the collector thread.
+  SystemInfo m_info;
+  std::array<std::shared_ptr<const SystemInfo>, 2> m_slots;
+  std::atomic<int> m_current = 0;         // slot readers copy from
+  mutable std::atomic<int> m_readers = 0; // readers inside snapshot()
+  std::atomic<bool> m_notifyPending = false;
+
+  HyprlandIpc *m_hyprland = nullptr;
+  I3Ipc *m_i3 = nullptr;
+  int m_redetectDelayMs = kMinRedetectMs;
+
+  CpuSampler m_cpuSampler;
+  MemSampler m_memSampler;
+
+  void publish();
+  void detectWindowManager();
+  void setupSystemMonitoring();
+  void setupWorkspaceMonitoring();
+  void scheduleRedetect();
+  void updateCpuUsage();
+  void updateMemoryUsage();
+  void updateWorkspaceInfo();
+};
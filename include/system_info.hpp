@@ -18,50 +18,34 @@
 #include <QWidget>
 #include <QWindow>
 
-enum class WindowManager : uint8_t { Unknown, I3, Hyprland, Sway, Other };
+#include <QThread>
 
+#include <memory>
+
+#include "system_collector.hpp"
+
+// GUI-side handle on the collector thread. Re-emits its snapshots as
+// systemInfoUpdated() on the thread that owns the monitor.
 class SystemMonitor : public QObject {
   Q_OBJECT
 
 public:
-  struct SystemInfo {
-    double cpuUsage = 0.0;
-    double memoryUsage = 0.0;
-    double swapUsage = 0.0;
-    QString currentWindow;
-    QString currentWorkspace;
-  };
+  using SystemInfo = ::SystemInfo;
 
   SystemMonitor(QObject *parent = nullptr);
-  SystemInfo getSystemInfo() const;
+  ~SystemMonitor() override;
+
+  // Starts the collector thread. Until then getSystemInfo() returns an
+  // empty snapshot and ticks queue up for the collector.
+  void start();
+
+  std::shared_ptr<const SystemInfo> getSystemInfo() const;
   WindowManager getWindowManager() const;
 
 signals:
   void systemInfoUpdated();
 
-private slots:
-  void updateSystemInfo();
-
 private:
-  SystemInfo m_systemInfo;
-  WindowManager m_windowManager = WindowManager::Unknown;
-  QTimer *m_updateTimer;
-  QProcess *m_workspaceProcess = nullptr;
-
-  // CPU monitoring
-  struct CpuTimes {
-    long long idle = 0;
-    long long total = 0;
-  };
-  CpuTimes m_lastCpuTimes;
-
-  void detectWindowManager();
-  void setupSystemMonitoring();
-  void setupWorkspaceMonitoring();
-  void updateCpuUsage();
-  void updateMemoryUsage();
-  void updateWorkspaceInfo();
-  void updateI3Info();
-  QString findFocusedWindow(const QJsonObject &node);
-  void updateHyprlandInfo();
+  QThread m_thread;
+  SystemCollector *m_collector;
 };
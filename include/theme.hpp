@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class Color : uint8_t {
+  Base00,
+  Base01,
+  Base02,
+  Base03,
+  Base04,
+  Base05,
+  Base06,
+  Base07,
+  Base08,
+  Base09,
+  Base0A,
+  Base0B,
+  Base0C,
+  Base0D,
+  Base0E,
+  Base0F,
+  Count,
+};
+
+// The base16 palette and the application stylesheet built from it. The
+// stylix palette is read once into an array indexed by Color, falling back
+// per entry to the compiled-in colors.hpp. style.css refers to it as
+// var(--base0D); those references are substituted when the stylesheet is
+// generated, so widgets are styled by class property or type alone and
+// never carry a stylesheet of their own.
+class Theme {
+public:
+  using Palette = std::array<QRgb, static_cast<size_t>(Color::Count)>;
+
+  static const Palette &palette();
+  static QColor color(Color color) {
+    return QColor(palette()[static_cast<size_t>(color)]);
+  }
+
+  // Re-reads ~/.config/stylix/palette.json. Returns true if it changed.
+  static bool reloadPalette();
+
+  // style.css with every var(--baseXX) replaced by the palette color.
+  static QString stylesheet();
+
+private:
+  static Palette &mutablePalette();
+  static Palette loadPalette();
+};
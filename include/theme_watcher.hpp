@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// Hot reload for a style.css override in ~/.config/obolc/assets and the
+// stylix palette.json. Editor save bursts are debounced into one reload,
+// and a reload that leaves the generated stylesheet effectively unchanged
+// is not applied, since Qt repolishes every widget on setStyleSheet.
+class ThemeWatcher : public QObject {
+  Q_OBJECT
+
+public:
+  explicit ThemeWatcher(QObject *parent = nullptr);
+
+private:
+  static constexpr int kDebounceMs = 150;
+
+  QFileSystemWatcher *m_watcher;
+  QTimer *m_debounce;
+  QString m_applied; // normalized form of the stylesheet in use
+
+  void watchPaths();
+  void reload();
+  static QString normalize(const QString &css);
+};
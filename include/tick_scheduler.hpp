@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QWidget>
+
+#include <functional>
+
+// One timer for all periodic work. Modules register a period and phase in
+// whole seconds and run on the wall-clock second boundaries where
+// (epochSecond - phase) % period == 0, so compatible periods share a wakeup
+// and clocks flip exactly on the second. The timer is only armed for the
+// next boundary at which some active module is due.
+class TickScheduler : public QObject {
+  Q_OBJECT
+
+public:
+  // Lives on the GUI thread and is owned by the application.
+  static TickScheduler *instance();
+
+  // fn runs on the GUI thread until remove(id) or until context is
+  // destroyed. With visibleOnly set, the module is suspended while that
+  // widget is hidden and runs once right after it is shown again.
+  int add(const QString &name, int periodSec, int phaseSec, QObject *context,
+          std::function<void()> fn, QWidget *visibleOnly = nullptr);
+  void remove(int id);
+
+  // "name (every Ns): X.X/min" per module, plus the total wakeups.
+  QStringList stats() const;
+
+protected:
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  struct Module {
+    QString name;
+    int period = 1;
+    int phase = 0;
+    QPointer<QObject> context;
+    std::function<void()> fn;
+    QPointer<QWidget> widget;
+    bool visibleOnly = false;
+    qint64 dueSec = 0;
+    quint64 runs = 0;
+  };
+
+  // Fire a little after the boundary so clock reads are already past it.
+  static constexpr int kSlackMs = 2;
+
+  explicit TickScheduler(QObject *parent);
+
+  QTimer *m_timer;
+  QMap<int, Module> m_modules;
+  int m_nextId = 1;
+  quint64 m_wakeups = 0;
+  QElapsedTimer m_uptime;
+
+  void tick();
+  void reschedule();
+  static bool isActive(const Module &module);
+  static qint64 nextDue(const Module &module, qint64 afterSec);
+};
@@ -0,0 +1,175 @@
+#include "album_art.hpp"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrl>
+
+#include <cmath>
+
+AlbumArt::AlbumArt(QObject *parent)
+    : QObject(parent), m_diskDir(QDir::homePath() + "/.cache/obolc/art") {
+  QDir().mkpath(m_diskDir);
+  m_pool.setMaxThreadCount(2);
+}
+
+QPixmap AlbumArt::thumbnail(const QString &url, int size, qreal dpr) {
+  if (url.isEmpty())
+    return {};
+
+  int pixelSize = static_cast<int>(std::ceil(size * dpr));
+  QUrl source(url);
+  QString key = QString("%1@%2").arg(url).arg(pixelSize);
+  if (source.isLocalFile()) {
+    // Players often rewrite one fixed file (e.g. /tmp/cover.jpg) per track,
+    // so local art is keyed on its size and mtime as well.
+    QFileInfo info(source.toLocalFile());
+    key += QString("|%1|%2")
+               .arg(info.size())
+               .arg(info.lastModified().toMSecsSinceEpoch());
+  }
+
+  if (auto *cached = m_cache.object(key))
+    return *cached;
+  if (m_pending.contains(key))
+    return {};
+  if (auto failed = m_failed.constFind(key); failed != m_failed.cend()) {
+    if (!failed->hasExpired())
+      return {}; // a 404 or undecodable file; don't refetch on every paint
+    m_failed.erase(failed);
+  }
+  m_pending.insert(key);
+
+  QString path = diskPath(key);
+
+  m_pool.start([this, key, url, path, source, pixelSize, dpr] {
+    // 1. Thumbnail decoded on a previous run
+    if (QFile::exists(path)) {
+      QImage image(path);
+      if (!image.isNull()) {
+        // Bump mtime so disk pruning evicts least recently used first
+        QFile file(path);
+        if (file.open(QIODevice::ReadWrite))
+          file.setFileTime(QDateTime::currentDateTime(),
+                           QFileDevice::FileModificationTime);
+        QMetaObject::invokeMethod(
+            this, [=, this] { finish(key, url, image, dpr); },
+            Qt::QueuedConnection);
+        return;
+      }
+    }
+
+    // 2. Local art is decoded here; remote art is fetched first
+    if (source.isLocalFile()) {
+      QImageReader reader(source.toLocalFile());
+      QImage image = readScaled(reader, pixelSize);
+      if (!image.isNull())
+        storeOnDisk(image, path, m_diskDir);
+      QMetaObject::invokeMethod(
+          this, [=, this] { finish(key, url, image, dpr); },
+          Qt::QueuedConnection);
+    } else {
+      QMetaObject::invokeMethod(
+          this, [=, this] { fetchRemote(key, url, pixelSize, dpr); },
+          Qt::QueuedConnection);
+    }
+  });
+
+  return {};
+}
+
+void AlbumArt::fetchRemote(const QString &key, const QString &url,
+                           int pixelSize, qreal dpr) {
+  QUrl source(url);
+  if (source.scheme() != "http" && source.scheme() != "https") {
+    finish(key, url, {}, dpr); // unknown scheme
+    return;
+  }
+
+  if (!m_network) {
+    m_network = new QNetworkAccessManager(this);
+    // A stalled server would otherwise keep the key pending for good.
+    m_network->setTransferTimeout(kTransferTimeoutMs);
+  }
+
+  QNetworkReply *reply = m_network->get(QNetworkRequest(source));
+  connect(reply, &QNetworkReply::finished, this,
+          [this, reply, key, url, pixelSize, dpr] {
+            reply->deleteLater();
+            if (reply->error() != QNetworkReply::NoError) {
+              qWarning() << "Failed to fetch album art" << url << ":"
+                         << reply->errorString();
+              finish(key, url, {}, dpr);
+              return;
+            }
+
+            QByteArray data = reply->readAll();
+            QString path = diskPath(key);
+            m_pool.start([this, key, url, path, data, pixelSize, dpr] {
+              QBuffer buffer;
+              buffer.setData(data);
+              buffer.open(QIODevice::ReadOnly);
+              QImageReader reader(&buffer);
+              QImage image = readScaled(reader, pixelSize);
+              if (!image.isNull())
+                storeOnDisk(image, path, m_diskDir);
+              QMetaObject::invokeMethod(
+                  this, [=, this] { finish(key, url, image, dpr); },
+                  Qt::QueuedConnection);
+            });
+          });
+}
+
+void AlbumArt::finish(const QString &key, const QString &url,
+                      const QImage &image, qreal dpr) {
+  m_pending.remove(key);
+  if (image.isNull()) {
+    m_failed.removeIf([](QHash<QString, QDeadlineTimer>::iterator it) {
+      return it->hasExpired();
+    });
+    m_failed.insert(key, QDeadlineTimer(kRetryMs));
+    return;
+  }
+
+  // QPixmap may only be created on the GUI thread
+  auto *pixmap = new QPixmap(QPixmap::fromImage(image));
+  pixmap->setDevicePixelRatio(dpr);
+  m_cache.insert(key, pixmap);
+  emit artReady(url);
+}
+
+QString AlbumArt::diskPath(const QString &key) const {
+  QByteArray hash =
+      QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+  return QString("%1/%2.png").arg(m_diskDir, QString::fromLatin1(hash));
+}
+
+QImage AlbumArt::readScaled(QImageReader &reader, int pixelSize) {
+  // Let the decoder produce the thumbnail directly (e.g. JPEG DCT scaling)
+  // instead of decoding full size and scaling afterwards.
+  QSize source = reader.size();
+  if (source.isValid()) {
+    reader.setScaledSize(
+        source.scaled(pixelSize, pixelSize, Qt::KeepAspectRatio));
+  }
+  return reader.read();
+}
+
+void AlbumArt::storeOnDisk(const QImage &image, const QString &path,
+                           const QString &dir) {
+  if (!image.save(path, "PNG"))
+    return;
+
+  QFileInfoList entries =
+      QDir(dir).entryInfoList(QDir::Files, QDir::Time); // newest first
+  for (qsizetype i = kDiskEntries; i < entries.size(); ++i)
+    QFile::remove(entries[i].filePath());
+}
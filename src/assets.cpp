@@ -0,0 +1,92 @@
+#include "assets.hpp"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QResource>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const QString kResourcePrefix = ":/assets/";
+
+QString Assets::path(const QString &name) {
+  if (auto it = overrides().constFind(name); it != overrides().cend())
+    return it.value();
+  QString resource = kResourcePrefix + name;
+  return QFileInfo::exists(resource) ? resource : QString();
+}
+
+QByteArray Assets::read(const QString &name) {
+  if (auto it = overrides().constFind(name); it != overrides().cend()) {
+    QByteArray data = readOverride(it.value());
+    if (!data.isNull())
+      return data;
+  }
+  return readResource(name);
+}
+
+QString Assets::overrideDir() {
+  return QDir::homePath() + "/.config/obolc/assets";
+}
+
+void Assets::rescan() { overrides() = scan(); }
+
+QHash<QString, QString> &Assets::overrides() {
+  static QHash<QString, QString> table = scan();
+  return table;
+}
+
+QHash<QString, QString> Assets::scan() {
+  QHash<QString, QString> table;
+  QDir dir(overrideDir());
+  for (const QFileInfo &entry : dir.entryInfoList(QDir::Files | QDir::Readable))
+    table.insert(entry.fileName(), entry.absoluteFilePath());
+  return table;
+}
+
+QByteArray Assets::readResource(const QString &name) {
+  QResource resource(kResourcePrefix + name);
+  if (!resource.isValid()) {
+    qWarning() << "Asset not found:" << name;
+    return {};
+  }
+  if (resource.compressionAlgorithm() != QResource::NoCompression)
+    return resource.uncompressedData();
+
+  // Resource data lives in the binary's read-only data for the whole run.
+  const auto *data = reinterpret_cast<const char *>(resource.data());
+  return QByteArray::fromRawData(data, resource.size());
+}
+
+QByteArray Assets::readOverride(const QString &path) {
+  int fd = open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    qWarning() << "Could not open asset override" << path << ":"
+               << strerror(errno);
+    return {};
+  }
+
+  QByteArray data;
+  struct stat st{};
+  if (fstat(fd, &st) == 0) {
+    data.resize(static_cast<qsizetype>(st.st_size));
+    qsizetype done = 0;
+    // One read() for a regular file; the loop only covers short reads.
+    while (done < data.size()) {
+      ssize_t n = ::read(fd, data.data() + done,
+                         static_cast<size_t>(data.size() - done));
+      if (n <= 0)
+        break;
+      done += n;
+    }
+    data.truncate(done);
+  }
+  close(fd);
+  return data;
+}
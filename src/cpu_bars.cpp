@@ -0,0 +1,52 @@
+#include "cpu_bars.hpp"
+
+#include <QPainter>
+#include <QStyleOption>
+
+#include <algorithm>
+#include <cmath>
+
+CpuBars::CpuBars(QWidget *parent) : QWidget(parent) {
+  setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Preferred);
+}
+
+void CpuBars::setValues(const QList<double> &values) {
+  // Bars are a few pixels tall; skip repaints that would not move a pixel.
+  bool changed = values.size() != m_values.size();
+  for (qsizetype i = 0; !changed && i < values.size(); ++i)
+    changed = std::abs(values[i] - m_values[i]) >= 1.0;
+  if (!changed)
+    return;
+
+  bool resized = values.size() != m_values.size();
+  m_values = values;
+  if (resized)
+    updateGeometry();
+  update();
+}
+
+QSize CpuBars::sizeHint() const {
+  auto count = static_cast<int>(m_values.size());
+  int width = count * kBarWidth + std::max(0, count - 1) * kBarGap;
+  QMargins margins = contentsMargins();
+  return {width + margins.left() + margins.right(), 16};
+}
+
+void CpuBars::paintEvent(QPaintEvent *) {
+  QPainter painter(this);
+
+  // Draw the stylesheet background and border like a QLabel would
+  QStyleOption opt;
+  opt.initFrom(this);
+  style()->drawPrimitive(QStyle::PE_Widget, &opt, &painter, this);
+
+  QRect area = contentsRect();
+  QColor color = palette().color(QPalette::WindowText);
+  int x = area.left();
+  for (double value : m_values) {
+    auto height = static_cast<int>(
+        std::lround(area.height() * std::clamp(value, 0.0, 100.0) / 100.0));
+    painter.fillRect(x, area.bottom() - height + 1, kBarWidth, height, color);
+    x += kBarWidth + kBarGap;
+  }
+}
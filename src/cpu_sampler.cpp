@@ -0,0 +1,114 @@
+#include "cpu_sampler.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Worst-case length of one "cpuN" line: a name plus ten 20-digit counters.
+static constexpr size_t kMaxCpuLine = 256;
+
+CpuSampler::CpuSampler() {
+  m_fd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+
+  long cores = sysconf(_SC_NPROCESSORS_CONF);
+  size_t slots = static_cast<size_t>(std::max(cores, 1L)) + 1;
+
+  m_buffer.resize(slots * kMaxCpuLine);
+  m_total.assign(slots, 0.0);
+  m_idle.assign(slots, 0.0);
+  m_prevTotal.assign(slots, 0.0);
+  m_prevIdle.assign(slots, 0.0);
+  m_usage.assign(slots, 0.0);
+}
+
+CpuSampler::~CpuSampler() {
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CpuSampler::sample() {
+  if (m_fd < 0)
+    return false;
+
+  ssize_t n = pread(m_fd, m_buffer.data(), m_buffer.size(), 0);
+  if (n <= 0)
+    return false;
+
+  const char *p = m_buffer.data();
+  const char *end = p + n;
+
+  // cpu lines come first; stop at the first line that is not one.
+  while (end - p > 3 && p[0] == 'c' && p[1] == 'p' && p[2] == 'u') {
+    p += 3;
+
+    size_t slot = 0;
+    if (*p != ' ') {
+      size_t index = 0;
+      auto [ptr, ec] = std::from_chars(p, end, index);
+      if (ec != std::errc())
+        break;
+      p = ptr;
+      slot = index + 1;
+    }
+
+    // user nice system idle iowait irq softirq steal guest guest_nice
+    uint64_t f[10] = {};
+    for (uint64_t &field : f) {
+      while (p < end && *p == ' ')
+        ++p;
+      auto [ptr, ec] = std::from_chars(p, end, field);
+      if (ec != std::errc())
+        break;
+      p = ptr;
+    }
+    while (p < end && *p != '\n')
+      ++p;
+    if (p < end)
+      ++p;
+
+    if (slot >= m_total.size())
+      continue; // core hot-added since startup
+
+    // guest/guest_nice are already accounted in user/nice.
+    uint64_t idle = f[3] + f[4];
+    uint64_t busy = f[0] + f[1] + f[2] + f[5] + f[6] + f[7];
+    m_total[slot] = static_cast<double>(idle + busy);
+    m_idle[slot] = static_cast<double>(idle);
+
+    if (slot == 0) {
+      m_stealTicks = static_cast<double>(f[7]);
+      m_guestTicks = static_cast<double>(f[8] + f[9]);
+    }
+  }
+
+  if (m_primed) {
+    const size_t slots = m_total.size();
+    const double *total = m_total.data();
+    const double *idle = m_idle.data();
+    const double *prevTotal = m_prevTotal.data();
+    const double *prevIdle = m_prevIdle.data();
+    double *usage = m_usage.data();
+
+    for (size_t i = 0; i < slots; ++i) {
+      double dt = total[i] - prevTotal[i];
+      double di = idle[i] - prevIdle[i];
+      usage[i] = dt > 0.0 ? (dt - di) * 100.0 / dt : 0.0;
+    }
+
+    double dt = m_total[0] - m_prevTotal[0];
+    if (dt > 0.0) {
+      m_steal = (m_stealTicks - m_prevStealTicks) * 100.0 / dt;
+      m_guest = (m_guestTicks - m_prevGuestTicks) * 100.0 / dt;
+    }
+  }
+
+  std::copy(m_total.begin(), m_total.end(), m_prevTotal.begin());
+  std::copy(m_idle.begin(), m_idle.end(), m_prevIdle.begin());
+  m_prevStealTicks = m_stealTicks;
+  m_prevGuestTicks = m_guestTicks;
+  m_primed = true;
+  return true;
+}
@@ -0,0 +1,184 @@
+#include "custom_module.hpp"
+
+#include "process_runner.hpp"
+#include "startup_trace.hpp"
+#include "tick_scheduler.hpp"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStyle>
+
+#include <algorithm>
+
+QList<CustomModule::Config> CustomModule::loadConfig() {
+  StartupTrace::Span span("CustomModule::loadConfig");
+  QFile file(QDir::homePath() + "/.config/obolc/modules.json");
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+
+  QJsonParseError err;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &err);
+  if (err.error != QJsonParseError::NoError) {
+    qWarning() << "modules.json:" << err.errorString();
+    return {};
+  }
+
+  QList<Config> configs;
+  for (const QJsonValue &value : doc.object().value("modules").toArray()) {
+    QJsonObject object = value.toObject();
+    Config config;
+    config.name = object.value("name").toString();
+    config.exec = object.value("exec").toString();
+    config.intervalSec = object.value("interval").toInt(0);
+    config.json = object.value("return-type").toString() == "json";
+    config.left = object.value("position").toString() == "left";
+
+    if (config.name.isEmpty() || config.exec.isEmpty()) {
+      qWarning() << "modules.json: skipping module without name or exec";
+      continue;
+    }
+    configs << config;
+  }
+  return configs;
+}
+
+CustomModule::CustomModule(const Config &config, QWidget *parent)
+    : QLabel(parent), m_config(config) {
+  setObjectName("custom-" + m_config.name);
+  setProperty("class", "custom");
+
+  m_repaintTimer = new QTimer(this);
+  m_repaintTimer->setSingleShot(true);
+  connect(m_repaintTimer, &QTimer::timeout, this, &CustomModule::applyLine);
+}
+
+void CustomModule::start() {
+  if (m_config.intervalSec > 0) {
+    TickScheduler::instance()->add("custom " + m_config.name,
+                                   m_config.intervalSec, 0, this,
+                                   [this] { runOnce(); });
+    runOnce();
+  } else {
+    startStream();
+  }
+}
+
+void CustomModule::startStream() {
+  m_process = new QProcess(this);
+  m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  connect(m_process, &QProcess::readyReadStandardOutput, this,
+          &CustomModule::readStream);
+
+  // Crashed or exited scripts come back, slower each time they fail fast.
+  m_restartTimer = new QTimer(this);
+  m_restartTimer->setSingleShot(true);
+  connect(m_restartTimer, &QTimer::timeout, this, &CustomModule::launch);
+  connect(m_process, &QProcess::finished, this, &CustomModule::scheduleRestart);
+  connect(m_process, &QProcess::errorOccurred, this,
+          [this](QProcess::ProcessError error) {
+            // Every other error is followed by finished().
+            if (error == QProcess::FailedToStart)
+              scheduleRestart();
+          });
+
+  launch();
+}
+
+void CustomModule::launch() {
+  m_runTime.start();
+  m_process->start("/bin/sh", {"-c", m_config.exec});
+  m_process->closeWriteChannel();
+}
+
+void CustomModule::scheduleRestart() {
+  // Only a run that stayed up counts as healthy. A script that prints one
+  // line and exits backs off to kMaxBackoffMs like one that fails.
+  if (m_runTime.elapsed() >= kHealthyRunMs)
+    m_backoffMs = kMinBackoffMs;
+
+  if (m_backoffMs != m_loggedBackoffMs) {
+    qWarning() << "Custom module" << m_config.name << "exited, restarting in"
+               << m_backoffMs << "ms";
+    m_loggedBackoffMs = m_backoffMs;
+  }
+  m_restartTimer->start(m_backoffMs);
+  m_backoffMs = std::min(m_backoffMs * 2, kMaxBackoffMs);
+}
+
+void CustomModule::readStream() {
+  QByteArray latest;
+  while (m_process->canReadLine())
+    latest = m_process->readLine();
+
+  // A script that never prints a newline must not grow the buffer forever.
+  if (m_process->bytesAvailable() > kMaxLineBytes)
+    m_process->readAll();
+
+  if (!latest.isNull())
+    queueLine(latest);
+}
+
+void CustomModule::runOnce() {
+  if (m_inFlight)
+    return; // previous run has not finished; skip this period
+  m_inFlight = true;
+
+  ProcessRunner::Options options;
+  options.timeoutMs = std::max(m_config.intervalSec * 1000, 1000);
+  ProcessRunner::instance()->run(
+      "/bin/sh", {"-c", m_config.exec}, this,
+      [this](const ProcessResult &result) {
+        m_inFlight = false;
+        QByteArray out = result.stdOut.trimmed();
+        // Only the last line counts, as in streaming mode.
+        queueLine(out.mid(out.lastIndexOf('\n') + 1));
+      },
+      options);
+}
+
+void CustomModule::queueLine(const QByteArray &line) {
+  m_pendingLine = line;
+  if (m_repaintTimer->isActive())
+    return;
+
+  qint64 sinceLast = m_lastRepaint.isValid() ? m_lastRepaint.elapsed()
+                                             : kMinRepaintMs;
+  if (sinceLast >= kMinRepaintMs)
+    applyLine();
+  else
+    m_repaintTimer->start(static_cast<int>(kMinRepaintMs - sinceLast));
+}
+
+void CustomModule::applyLine() {
+  m_lastRepaint.start();
+
+  QString text;
+  QString tooltip;
+  QString cssClass;
+  if (m_config.json) {
+    QJsonObject object = QJsonDocument::fromJson(m_pendingLine).object();
+    text = object.value("text").toString();
+    tooltip = object.value("tooltip").toString();
+    cssClass = object.value("class").toString();
+  } else {
+    text = QString::fromUtf8(m_pendingLine).trimmed();
+  }
+
+  if (text != this->text())
+    setText(text);
+  if (tooltip != toolTip())
+    setToolTip(tooltip);
+  setVisible(!text.isEmpty());
+
+  // Exposed as the "state" property so styles can use [state="warning"].
+  if (cssClass != m_class) {
+    m_class = cssClass;
+    setProperty("state", m_class);
+    style()->unpolish(this);
+    style()->polish(this);
+  }
+}
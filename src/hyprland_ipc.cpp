@@ -0,0 +1,186 @@
+#include "hyprland_ipc.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <memory>
+
+HyprlandIpc::HyprlandIpc(QObject *parent) : QObject(parent) {
+  m_events = new QLocalSocket(this);
+  connect(m_events, &QLocalSocket::connected, this, [this] {
+    m_failures = 0;
+    requestSnapshot();
+  });
+  connect(m_events, &QLocalSocket::readyRead, this, &HyprlandIpc::readEvents);
+
+  // Compositor restarts or socket hiccups: retry instead of going stale.
+  m_reconnectTimer = new QTimer(this);
+  m_reconnectTimer->setSingleShot(true);
+  m_reconnectTimer->setInterval(1000);
+  connect(m_reconnectTimer, &QTimer::timeout, this,
+          &HyprlandIpc::connectEvents);
+  connect(m_events, &QLocalSocket::disconnected, m_reconnectTimer,
+          qOverload<>(&QTimer::start));
+  connect(m_events, &QLocalSocket::errorOccurred, this,
+          [this](QLocalSocket::LocalSocketError) {
+            if (m_events->state() != QLocalSocket::UnconnectedState)
+              return;
+            if (++m_failures >= kMaxFailures)
+              emit connectionLost();
+            else
+              m_reconnectTimer->start();
+          });
+}
+
+QString HyprlandIpc::socketDir() {
+  QString signature = qEnvironmentVariable("HYPRLAND_INSTANCE_SIGNATURE");
+  QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+
+  if (!signature.isEmpty()) {
+    for (const QString &dir : {runtimeDir + "/hypr/" + signature,
+                               "/tmp/hypr/" + signature}) {
+      if (QFile::exists(dir + "/.socket2.sock"))
+        return dir;
+    }
+  }
+
+  if (runtimeDir.isEmpty())
+    return {};
+
+  // Our environment may name an instance that has since been restarted.
+  QDir hyprDir(runtimeDir + "/hypr");
+  const QFileInfoList instances =
+      hyprDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Time);
+  for (const QFileInfo &instance : instances) {
+    if (QFile::exists(instance.filePath() + "/.socket2.sock"))
+      return instance.filePath();
+  }
+  return {};
+}
+
+void HyprlandIpc::start(const QString &dir) {
+  m_dir = dir;
+  connectEvents();
+}
+
+void HyprlandIpc::connectEvents() {
+  if (m_events->state() != QLocalSocket::UnconnectedState)
+    return;
+
+  // A restarted compositor comes back under a new instance signature.
+  if (!QFile::exists(m_dir + "/.socket2.sock")) {
+    if (QString dir = socketDir(); !dir.isEmpty())
+      m_dir = dir;
+  }
+  if (m_dir.isEmpty())
+    return;
+  m_buffer.clear();
+  m_events->connectToServer(m_dir + "/.socket2.sock");
+}
+
+void HyprlandIpc::readEvents() {
+  m_buffer.append(m_events->readAll());
+
+  // Events are "name>>data\n"; consume complete lines, keep the tail.
+  qsizetype start = 0;
+  for (;;) {
+    qsizetype newline = m_buffer.indexOf('\n', start);
+    if (newline < 0)
+      break;
+
+    QByteArrayView line(m_buffer.constData() + start, newline - start);
+    qsizetype sep = line.indexOf(">>");
+    if (sep > 0)
+      handleEvent(line.first(sep), line.sliced(sep + 2));
+    start = newline + 1;
+  }
+  m_buffer.remove(0, start);
+}
+
+void HyprlandIpc::handleEvent(QByteArrayView name, QByteArrayView data) {
+  auto afterComma = [](QByteArrayView view) {
+    qsizetype comma = view.indexOf(',');
+    return comma < 0 ? QByteArrayView() : view.sliced(comma + 1);
+  };
+  auto beforeComma = [](QByteArrayView view) {
+    qsizetype comma = view.indexOf(',');
+    return comma < 0 ? view : view.first(comma);
+  };
+
+  if (name == "workspacev2") { // ID,NAME
+    setWorkspace(QString::fromUtf8(beforeComma(data)),
+                 QString::fromUtf8(afterComma(data)));
+  } else if (name == "workspace") { // NAME (pre-v2 compositors)
+    setWorkspace(m_workspaceId, QString::fromUtf8(data));
+  } else if (name == "focusedmon") { // MONITOR,WORKSPACE
+    // The id still names the other monitor's workspace; drop it so a rename
+    // there cannot match, until the new one is known.
+    setWorkspace({}, QString::fromUtf8(afterComma(data)));
+    requestWorkspace();
+  } else if (name == "focusedmonv2") { // MONITOR,ID
+    m_workspaceId = QString::fromUtf8(afterComma(data));
+  } else if (name == "renameworkspace") { // ID,NEWNAME
+    if (QString::fromUtf8(beforeComma(data)) == m_workspaceId)
+      setWorkspace(m_workspaceId, QString::fromUtf8(afterComma(data)));
+  } else if (name == "activewindow") { // CLASS,TITLE (titles may hold commas)
+    setTitle(QString::fromUtf8(afterComma(data)));
+  }
+}
+
+void HyprlandIpc::requestSnapshot() {
+  requestWorkspace();
+  request("j/activewindow", [this](const QByteArray &reply) {
+    setTitle(QJsonDocument::fromJson(reply).object()["title"].toString());
+  });
+}
+
+void HyprlandIpc::requestWorkspace() {
+  request("j/activeworkspace", [this](const QByteArray &reply) {
+    QJsonObject workspace = QJsonDocument::fromJson(reply).object();
+    if (!workspace.isEmpty())
+      setWorkspace(QString::number(workspace["id"].toInt()),
+                   workspace["name"].toString());
+  });
+}
+
+void HyprlandIpc::request(const QByteArray &command,
+                          std::function<void(const QByteArray &)> onReply) {
+  // Hyprland answers one command per connection and then closes it.
+  auto *socket = new QLocalSocket(this);
+  auto reply = std::make_shared<QByteArray>();
+
+  connect(socket, &QLocalSocket::connected, socket,
+          [socket, command] { socket->write(command); });
+  connect(socket, &QLocalSocket::readyRead, socket,
+          [socket, reply] { reply->append(socket->readAll()); });
+  connect(socket, &QLocalSocket::disconnected, this,
+          [socket, reply, onReply] {
+            reply->append(socket->readAll());
+            socket->deleteLater();
+            onReply(*reply);
+          });
+  connect(socket, &QLocalSocket::errorOccurred, socket,
+          [socket](QLocalSocket::LocalSocketError error) {
+            if (error != QLocalSocket::PeerClosedError)
+              socket->deleteLater();
+          });
+
+  socket->connectToServer(m_dir + "/.socket.sock");
+}
+
+void HyprlandIpc::setWorkspace(const QString &id, const QString &name) {
+  m_workspaceId = id;
+  if (name == m_workspace)
+    return;
+  m_workspace = name;
+  emit workspaceChanged(m_workspace);
+}
+
+void HyprlandIpc::setTitle(const QString &title) {
+  if (title == m_title)
+    return;
+  m_title = title;
+  emit activeWindowChanged(m_title);
+}
@@ -0,0 +1,193 @@
+#include "i3_ipc.hpp"
+#include "i3_tree_scan.hpp"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <cstring>
+
+static constexpr char kMagic[] = {'i', '3', '-', 'i', 'p', 'c'};
+static constexpr qsizetype kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t);
+
+I3Ipc::I3Ipc(QObject *parent) : QObject(parent) {
+  m_socket = new QLocalSocket(this);
+  connect(m_socket, &QLocalSocket::connected, this, &I3Ipc::onConnected);
+  connect(m_socket, &QLocalSocket::readyRead, this, &I3Ipc::readMessages);
+
+  m_reconnectTimer = new QTimer(this);
+  m_reconnectTimer->setSingleShot(true);
+  m_reconnectTimer->setInterval(1000);
+  connect(m_reconnectTimer, &QTimer::timeout, this, &I3Ipc::connectSocket);
+  connect(m_socket, &QLocalSocket::disconnected, m_reconnectTimer,
+          qOverload<>(&QTimer::start));
+  connect(m_socket, &QLocalSocket::errorOccurred, this,
+          [this](QLocalSocket::LocalSocketError) {
+            if (m_socket->state() != QLocalSocket::UnconnectedState)
+              return;
+            if (++m_failures >= kMaxFailures)
+              emit connectionLost();
+            else
+              m_reconnectTimer->start();
+          });
+}
+
+QString I3Ipc::socketPath() {
+  QString path = qEnvironmentVariable("SWAYSOCK");
+  if (path.isEmpty())
+    path = qEnvironmentVariable("I3SOCK");
+  return path;
+}
+
+void I3Ipc::start(const QString &path) {
+  m_path = path;
+  connectSocket();
+}
+
+void I3Ipc::connectSocket() {
+  if (m_path.isEmpty() || m_socket->state() != QLocalSocket::UnconnectedState)
+    return;
+  m_buffer.clear();
+  m_socket->connectToServer(m_path);
+}
+
+void I3Ipc::onConnected() {
+  m_failures = 0;
+
+  // Events can be missed while disconnected, so resync from a full snapshot.
+  send(Subscribe, R"(["workspace","window"])");
+  send(GetWorkspaces);
+  send(GetTree);
+}
+
+void I3Ipc::send(uint32_t type, const QByteArray &payload) {
+  auto length = static_cast<uint32_t>(payload.size());
+
+  QByteArray message(kMagic, sizeof(kMagic));
+  message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  message.append(reinterpret_cast<const char *>(&type), sizeof(type));
+  message.append(payload);
+  m_socket->write(message);
+}
+
+void I3Ipc::readMessages() {
+  m_buffer.append(m_socket->readAll());
+
+  qsizetype offset = 0;
+  while (m_buffer.size() - offset >= kHeaderSize) {
+    const char *header = m_buffer.constData() + offset;
+    if (std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+      qWarning() << "i3-ipc: bad magic, reconnecting";
+      m_socket->abort();
+      return;
+    }
+
+    // Header integers use the host byte order.
+    uint32_t length = 0;
+    uint32_t type = 0;
+    std::memcpy(&length, header + sizeof(kMagic), sizeof(length));
+    std::memcpy(&type, header + sizeof(kMagic) + sizeof(length), sizeof(type));
+
+    auto payloadSize = static_cast<qsizetype>(length);
+    if (m_buffer.size() - offset - kHeaderSize < payloadSize)
+      break; // wait for the rest of the payload
+
+    handleMessage(type, m_buffer.mid(offset + kHeaderSize, payloadSize));
+    offset += kHeaderSize + payloadSize;
+  }
+  m_buffer.remove(0, offset);
+}
+
+void I3Ipc::handleMessage(uint32_t type, const QByteArray &payload) {
+  switch (type) {
+  case GetWorkspaces:
+    for (const QJsonValue &value : QJsonDocument::fromJson(payload).array()) {
+      QJsonObject ws = value.toObject();
+      if (ws["focused"].toBool()) {
+        setWorkspace(ws["name"].toString());
+        break;
+      }
+    }
+    break;
+  case GetTree: {
+    // Trees run to megabytes on busy sessions; scan instead of parsing a DOM.
+    std::string name = findFocusedName({payload.constData(),
+                                        static_cast<size_t>(payload.size())});
+    setTitle(QString::fromStdString(name));
+    break;
+  }
+  case kWorkspaceEvent:
+    handleWorkspaceEvent(QJsonDocument::fromJson(payload).object());
+    break;
+  case kWindowEvent:
+    handleWindowEvent(QJsonDocument::fromJson(payload).object());
+    break;
+  default:
+    break; // subscribe acks and events we did not ask for
+  }
+}
+
+void I3Ipc::handleWorkspaceEvent(const QJsonObject &event) {
+  QString change = event["change"].toString();
+  QJsonObject current = event["current"].toObject();
+
+  if (change == "focus") {
+    setWorkspace(current["name"].toString());
+    // An empty workspace gets no window event, so take focus from the
+    // workspace subtree carried by the event itself.
+    setTitle(findFocusedWindow(current));
+  } else if (change == "rename" && current["focused"].toBool()) {
+    setWorkspace(current["name"].toString());
+  }
+}
+
+void I3Ipc::handleWindowEvent(const QJsonObject &event) {
+  QString change = event["change"].toString();
+  QJsonObject container = event["container"].toObject();
+
+  if (change == "focus") {
+    setTitle(container["name"].toString());
+  } else if (change == "title" && container["focused"].toBool()) {
+    setTitle(container["name"].toString());
+  } else if (change == "close" && container["focused"].toBool()) {
+    setTitle({});
+  }
+}
+
+QString I3Ipc::findFocusedWindow(const QJsonObject &node) {
+  // A focused workspace means no window has focus; its name is not a title.
+  if (node["focused"].toBool() && node["type"].toString() != "workspace" &&
+      !node["name"].toString().isEmpty()) {
+    return node["name"].toString();
+  }
+
+  QJsonArray nodes = node["nodes"].toArray();
+  for (const QJsonValue &child : nodes) {
+    QString result = findFocusedWindow(child.toObject());
+    if (!result.isEmpty())
+      return result;
+  }
+
+  QJsonArray floating = node["floating_nodes"].toArray();
+  for (const QJsonValue &child : floating) {
+    QString result = findFocusedWindow(child.toObject());
+    if (!result.isEmpty())
+      return result;
+  }
+
+  return QString();
+}
+
+void I3Ipc::setWorkspace(const QString &workspace) {
+  if (workspace == m_workspace)
+    return;
+  m_workspace = workspace;
+  emit workspaceChanged(m_workspace);
+}
+
+void I3Ipc::setTitle(const QString &title) {
+  if (title == m_title)
+    return;
+  m_title = title;
+  emit activeWindowChanged(m_title);
+}
@@ -0,0 +1,194 @@
+#include "i3_tree_scan.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace {
+
+struct Frame {
+  bool focused = false;
+  bool workspace = false;
+  std::string_view name; // raw, still escaped
+};
+
+constexpr size_t kMaxDepth = 128;
+
+bool isDelimiter(char c) {
+  return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' ||
+         c == '\r' || c == '\t';
+}
+
+void appendUtf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+uint32_t parseHex4(std::string_view s, size_t i) {
+  uint32_t value = 0;
+  for (size_t k = i; k < i + 4 && k < s.size(); ++k) {
+    char c = s[k];
+    value <<= 4;
+    if (c >= '0' && c <= '9')
+      value |= static_cast<uint32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      value |= static_cast<uint32_t>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      value |= static_cast<uint32_t>(c - 'A' + 10);
+  }
+  return value;
+}
+
+std::string unescape(std::string_view raw) {
+  std::string out;
+  out.reserve(raw.size());
+  for (size_t i = 0; i < raw.size(); ++i) {
+    if (raw[i] != '\\' || i + 1 >= raw.size()) {
+      out += raw[i];
+      continue;
+    }
+    char e = raw[++i];
+    switch (e) {
+    case 'n':
+      out += '\n';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case 'b':
+      out += '\b';
+      break;
+    case 'f':
+      out += '\f';
+      break;
+    case 'u': {
+      uint32_t cp = parseHex4(raw, i + 1);
+      i += 4;
+      // Astral characters arrive as a surrogate pair: \ud83d\ude00
+      if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < raw.size() &&
+          raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+        uint32_t low = parseHex4(raw, i + 3);
+        if (low >= 0xDC00 && low <= 0xDFFF) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          i += 6;
+        }
+      }
+      appendUtf8(out, cp);
+      break;
+    }
+    default: // \" \\ \/
+      out += e;
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+std::string findFocusedName(std::string_view json) {
+  // Object frames hold the per-container facts we care about; `inObject`
+  // records whether each open container is an object or an array.
+  std::array<Frame, kMaxDepth> frames{};
+  std::array<bool, kMaxDepth> inObject{};
+  size_t depth = 0;
+
+  std::string_view key;
+  bool expectKey = false;
+
+  const size_t n = json.size();
+  for (size_t i = 0; i < n; ++i) {
+    char c = json[i];
+    switch (c) {
+    case '{':
+    case '[': {
+      if (depth > 0 && inObject[depth - 1] && c == '[' &&
+          (key == "nodes" || key == "floating_nodes")) {
+        // Children follow; if this container already qualifies, stop early.
+        const Frame &self = frames[depth - 1];
+        if (self.focused && !self.workspace && !self.name.empty())
+          return unescape(self.name);
+      }
+      if (depth == kMaxDepth)
+        return {}; // deeper than any real tree
+      inObject[depth] = c == '{';
+      frames[depth] = Frame{};
+      ++depth;
+      expectKey = c == '{';
+      break;
+    }
+    case '}':
+    case ']': {
+      if (depth == 0)
+        return {};
+      --depth;
+      if (c == '}') {
+        const Frame &self = frames[depth];
+        if (self.focused && !self.workspace && !self.name.empty())
+          return unescape(self.name);
+      }
+      expectKey = false;
+      break;
+    }
+    case ',':
+      expectKey = depth > 0 && inObject[depth - 1];
+      break;
+    case ':':
+      expectKey = false;
+      break;
+    case '"': {
+      size_t start = i + 1;
+      size_t end = start;
+      while (end < n && json[end] != '"')
+        end += json[end] == '\\' ? 2u : 1u;
+      if (end >= n)
+        return {};
+      std::string_view str = json.substr(start, end - start);
+      i = end;
+
+      if (expectKey) {
+        key = str;
+      } else if (depth > 0 && inObject[depth - 1]) {
+        Frame &self = frames[depth - 1];
+        if (key == "name")
+          self.name = str;
+        else if (key == "type")
+          self.workspace = str == "workspace";
+      }
+      break;
+    }
+    case ' ':
+    case '\n':
+    case '\r':
+    case '\t':
+      break;
+    default: {
+      // true / false / null / number
+      size_t start = i;
+      while (i + 1 < n && !isDelimiter(json[i + 1]))
+        ++i;
+      if (depth > 0 && inObject[depth - 1] && key == "focused")
+        frames[depth - 1].focused =
+            json.substr(start, i - start + 1) == "true";
+      break;
+    }
+    }
+  }
+
+  return {};
+}
@@ -0,0 +1,167 @@
+#include "icon_cache.hpp"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIcon>
+#include <QImageReader>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+IconCache *IconCache::instance() {
+  static auto *cache = new IconCache(QCoreApplication::instance());
+  return cache;
+}
+
+IconCache::IconCache(QObject *parent) : QObject(parent) {
+  if (qEnvironmentVariable("OBOLC_ICON_DISK_CACHE") != "0") {
+    m_diskDir = QDir::homePath() + "/.cache/obolc/icons";
+    QDir().mkpath(m_diskDir);
+  }
+  m_pool.setMaxThreadCount(1);
+}
+
+QPixmap IconCache::pixmap(const QString &source, int size, qreal dpr,
+                          const QColor &tint) {
+  if (source.isEmpty())
+    return {};
+
+  // The pixmap carries its DPR, so it is part of the key: 32 px at DPR 1
+  // and 16 px at DPR 2 share pixels but not how they are drawn. Files also
+  // key on their size and mtime, so edits show up without a restart.
+  int pixelSize = static_cast<int>(std::ceil(size * dpr));
+  QString key = QString("%1@%2x%3#%4%5")
+                    .arg(source)
+                    .arg(pixelSize)
+                    .arg(dpr)
+                    .arg(tint.isValid() ? tint.name(QColor::HexArgb) : "")
+                    .arg(fileVersion(source));
+
+  if (auto *cached = m_cache.object(key))
+    return *cached;
+  if (m_pending.contains(key))
+    return {};
+
+  // Theme lookups go through QIcon, which is GUI-thread only.
+  if (!source.startsWith('/') && !source.startsWith(':')) {
+    QImage image = QIcon::fromTheme(source)
+                       .pixmap(QSize(size, size), dpr)
+                       .toImage();
+    if (!image.isNull() && tint.isValid()) {
+      QPainter painter(&image);
+      painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+      painter.fillRect(image.rect(), tint);
+    }
+    finish(key, source, image, dpr);
+    auto *rendered = m_cache.object(key);
+    return rendered ? *rendered : QPixmap();
+  }
+
+  m_pending.insert(key);
+  QString path = m_diskDir.isEmpty() ? QString()
+                                     : diskPath(source, pixelSize, tint);
+
+  m_pool.start([this, key, source, path, pixelSize, tint, dpr] {
+    // 1. Raster from a previous run
+    if (!path.isEmpty() && QFile::exists(path)) {
+      QImage image(path);
+      if (!image.isNull()) {
+        // Bump mtime so disk pruning evicts least recently used first
+        QFile file(path);
+        if (file.open(QIODevice::ReadWrite))
+          file.setFileTime(QDateTime::currentDateTime(),
+                           QFileDevice::FileModificationTime);
+        QMetaObject::invokeMethod(
+            this, [=, this] { finish(key, source, image, dpr); },
+            Qt::QueuedConnection);
+        return;
+      }
+    }
+
+    // 2. Parse and rasterize
+    QImage image = render(source, pixelSize, tint);
+    if (!image.isNull() && !path.isEmpty())
+      storeOnDisk(image, path, m_diskDir);
+    QMetaObject::invokeMethod(
+        this, [=, this] { finish(key, source, image, dpr); },
+        Qt::QueuedConnection);
+  });
+
+  return {};
+}
+
+void IconCache::finish(const QString &key, const QString &source,
+                       const QImage &image, qreal dpr) {
+  m_pending.remove(key);
+  if (image.isNull())
+    return;
+
+  // QPixmap may only be created on the GUI thread
+  auto *pixmap = new QPixmap(QPixmap::fromImage(image));
+  pixmap->setDevicePixelRatio(dpr);
+  auto cost = std::max<qsizetype>(image.sizeInBytes() / 1024, 1);
+  m_cache.insert(key, pixmap, cost);
+  emit iconReady(source);
+}
+
+QString IconCache::diskPath(const QString &source, int pixelSize,
+                            const QColor &tint) const {
+  // The source's size and mtime are part of the key, so an edited or
+  // replaced file (e.g. an asset override) is rendered afresh.
+  QByteArray id = QString("%1%2|%3|%4")
+                      .arg(source, fileVersion(source))
+                      .arg(pixelSize)
+                      .arg(tint.isValid() ? tint.name(QColor::HexArgb) : "")
+                      .toUtf8();
+  QByteArray hash =
+      QCryptographicHash::hash(id, QCryptographicHash::Sha1).toHex();
+  return QString("%1/%2.png").arg(m_diskDir, QString::fromLatin1(hash));
+}
+
+QString IconCache::fileVersion(const QString &source) {
+  if (!source.startsWith('/') && !source.startsWith(':'))
+    return {}; // theme name
+  QFileInfo info(source);
+  return QString("|%1|%2")
+      .arg(info.size())
+      .arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+QImage IconCache::render(const QString &source, int pixelSize,
+                         const QColor &tint) {
+  // The svg image format plugin renders at the scaled size directly, so
+  // the vector is rasterized once at the final resolution.
+  QImageReader reader(source);
+  QSize natural = reader.size();
+  QSize target = natural.isValid()
+                     ? natural.scaled(pixelSize, pixelSize, Qt::KeepAspectRatio)
+                     : QSize(pixelSize, pixelSize);
+  reader.setScaledSize(target);
+  QImage image = reader.read();
+  if (image.isNull())
+    return {};
+
+  image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+  if (tint.isValid()) {
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    painter.fillRect(image.rect(), tint);
+  }
+  return image;
+}
+
+void IconCache::storeOnDisk(const QImage &image, const QString &path,
+                            const QString &dir) {
+  if (!image.save(path, "PNG"))
+    return;
+
+  QFileInfoList entries =
+      QDir(dir).entryInfoList(QDir::Files, QDir::Time); // newest first
+  for (qsizetype i = kDiskEntries; i < entries.size(); ++i)
+    QFile::remove(entries[i].filePath());
+}
@@ -0,0 +1,191 @@
+#include "lyrics.hpp"
+
+#include <QDBusObjectPath>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QUrl>
+
+#include <algorithm>
+#include <cmath>
+
+Lyrics::Lyrics(Mpris *mpris, QObject *parent)
+    : QObject(parent), m_mpris(mpris) {
+  m_timer = new QTimer(this);
+  m_timer->setSingleShot(true);
+  m_timer->setTimerType(Qt::PreciseTimer);
+  connect(m_timer, &QTimer::timeout, this, &Lyrics::refresh);
+
+  // Seeks, track changes and play/pause all move the next line boundary.
+  auto refreshIfCurrent = [this](const QString &playerName) {
+    if (playerName == m_player)
+      refresh();
+  };
+  connect(m_mpris, &Mpris::playerPositionChanged, this, refreshIfCurrent);
+  connect(m_mpris, &Mpris::playerStateChanged, this, refreshIfCurrent);
+  connect(m_mpris, &Mpris::playerMetadataChanged, this, refreshIfCurrent);
+}
+
+void Lyrics::setPlayer(const QString &playerName) {
+  if (playerName == m_player)
+    return;
+  m_player = playerName;
+  refresh();
+}
+
+void Lyrics::refresh() {
+  m_timer->stop();
+
+  auto state = m_mpris->getPlayerState(m_player);
+  if (!state.has_value()) {
+    setLine({});
+    return;
+  }
+
+  const LyricsTrack *lines = trackLyrics(state->metadata);
+  if (!lines || lines->isEmpty()) {
+    setLine({});
+    return;
+  }
+
+  qint64 positionMs = state->positionUs() / 1000;
+  auto next = std::upper_bound(
+      lines->cbegin(), lines->cend(), positionMs,
+      [](qint64 t, const LyricLine &line) { return t < line.timeMs; });
+  setLine(next == lines->cbegin() ? QString() : std::prev(next)->text);
+
+  if (next == lines->cend() || state->playbackStatus != "Playing" ||
+      state->rate <= 0.0)
+    return;
+
+  // Wake exactly on the next boundary instead of polling every second.
+  double delayMs = static_cast<double>(next->timeMs - positionMs) / state->rate;
+  m_timer->start(std::max(1, static_cast<int>(std::ceil(delayMs))));
+}
+
+void Lyrics::setLine(const QString &line) {
+  if (line == m_currentLine)
+    return;
+  m_currentLine = line;
+  emit currentLineChanged(m_currentLine);
+}
+
+const LyricsTrack *Lyrics::trackLyrics(const QVariantMap &metadata) {
+  QString key = trackKey(metadata);
+  if (key.isEmpty())
+    return nullptr;
+
+  if (auto *cached = m_cache.object(key))
+    return cached;
+
+  auto *lines = new LyricsTrack;
+  QString path = findLrcFile(metadata);
+  if (!path.isEmpty()) {
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly))
+      *lines = parseLrc(QString::fromUtf8(file.readAll()));
+  }
+
+  // Misses are cached too, so a track without lyrics is probed only once.
+  m_cache.insert(key, lines);
+  return lines;
+}
+
+QString Lyrics::trackKey(const QVariantMap &metadata) {
+  QVariant trackId = metadata.value("mpris:trackid");
+  if (trackId.userType() == qMetaTypeId<QDBusObjectPath>())
+    return trackId.value<QDBusObjectPath>().path();
+  if (!trackId.toString().isEmpty())
+    return trackId.toString();
+
+  QString url = metadata.value("xesam:url").toString();
+  if (!url.isEmpty())
+    return url;
+
+  QString title = metadata.value("xesam:title").toString();
+  if (title.isEmpty())
+    return {};
+  return metadata.value("xesam:artist").toStringList().join(", ") + '\n' +
+         title;
+}
+
+QString Lyrics::findLrcFile(const QVariantMap &metadata) {
+  // 1. Next to the track: /music/song.flac -> /music/song.lrc
+  QUrl url(metadata.value("xesam:url").toString());
+  if (url.isLocalFile()) {
+    QFileInfo track(url.toLocalFile());
+    QString candidate = track.path() + "/" + track.completeBaseName() + ".lrc";
+    if (QFile::exists(candidate))
+      return candidate;
+  }
+
+  // 2. ~/.lyrics/<Artist> - <Title>.lrc, then ~/.lyrics/<Title>.lrc
+  QString title = metadata.value("xesam:title").toString();
+  if (title.isEmpty())
+    return {};
+  QString artist = metadata.value("xesam:artist").toStringList().value(0);
+
+  title.replace('/', '_');
+  artist.replace('/', '_');
+
+  QDir dir(QDir::homePath() + "/.lyrics");
+  QStringList candidates;
+  if (!artist.isEmpty())
+    candidates << artist + " - " + title + ".lrc";
+  candidates << title + ".lrc";
+
+  for (const QString &name : candidates) {
+    if (dir.exists(name))
+      return dir.filePath(name);
+  }
+
+  return {};
+}
+
+LyricsTrack Lyrics::parseLrc(const QString &content) {
+  LyricsTrack lines;
+  qint64 offsetMs = 0;
+
+  for (QStringView raw : QStringView(content).split(u'\n')) {
+    raw = raw.trimmed();
+
+    // A line may carry several timestamps: [00:12.30][01:40.00]text
+    QList<qint64> stamps;
+    qsizetype pos = 0;
+    while (pos < raw.size() && raw[pos] == u'[') {
+      qsizetype close = raw.indexOf(u']', pos);
+      if (close < 0)
+        break;
+      QStringView tag = raw.mid(pos + 1, close - pos - 1);
+      pos = close + 1;
+
+      qsizetype colon = tag.indexOf(u':');
+      if (colon < 0)
+        continue;
+
+      bool minutesOk = false;
+      bool secondsOk = false;
+      int minutes = tag.left(colon).toInt(&minutesOk);
+      double seconds = tag.mid(colon + 1).toDouble(&secondsOk);
+      if (minutesOk && secondsOk) {
+        stamps << minutes * 60'000LL + std::llround(seconds * 1000.0);
+      } else if (tag.startsWith(u"offset:")) {
+        offsetMs = tag.mid(colon + 1).trimmed().toLongLong();
+      }
+    }
+
+    QString text = raw.mid(pos).trimmed().toString();
+    for (qint64 stamp : stamps)
+      lines.append({stamp, text});
+  }
+
+  // Positive offsets make lyrics appear sooner.
+  for (LyricLine &line : lines)
+    line.timeMs = std::max<qint64>(0, line.timeMs - offsetMs);
+
+  std::stable_sort(lines.begin(), lines.end(),
+                   [](const LyricLine &a, const LyricLine &b) {
+                     return a.timeMs < b.timeMs;
+                   });
+  return lines;
+}
@@ -1,6 +1,10 @@
 #include "media_window.hpp"
 #include "mpris.hpp"
 #include "panel.hpp"
+#include "popup.hpp"
+#include "startup_trace.hpp"
+#include "theme.hpp"
+#include "theme_watcher.hpp"
 #include "utils.hpp"
 
 #include <QCoreApplication>
@@ -8,22 +12,48 @@
 #include <QDBusInterface>
 #include <QDBusReply>
 #include <QDebug>
+#include <QDir>
 #include <QTimer>
 #include <QVariantMap>
 
+#include <string_view>
+
 int main(int argc, char *argv[]) {
+  // Parsed before QApplication so that its construction is traced too.
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg(argv[i]);
+    if (arg == "--trace-startup")
+      StartupTrace::enable(QDir::tempPath() + "/obolc-startup.json");
+    else if (arg.starts_with("--trace-startup="))
+      StartupTrace::enable(QString::fromUtf8(arg.substr(16).data()));
+  }
+
+  StartupTrace::Span appSpan("QApplication");
   QApplication app(argc, argv);
-  app.setStyleSheet(QString::fromStdString(readAssetFile("style.css")));
+  appSpan.end();
 
+  StartupTrace::Span themeSpan("Theme::stylesheet");
+  app.setStyleSheet(Theme::stylesheet());
+  new ThemeWatcher(&app); // owned by app
+  themeSpan.end();
+
+  // Monitoring (a D-Bus round trip per player) starts after the first frame.
   Mpris mpris(&app);
-  mpris.startMonitoring(5000);
+  mpris.loadPolicy();
 
-  MediaWindow wm;
+  // Built on first open and released again after sitting hidden.
+  Popup mediaWindow([&mpris] { return new MediaWindow(&mpris); });
 
-  Panel panel;
-  panel.setupMediaWindow(&wm);
+  Panel panel(app.arguments().contains("--painted") ? PanelRenderer::Painted
+                                                   : PanelRenderer::Widgets);
+  panel.setupMediaWindow(&mediaWindow);
   panel.setupMpris(&mpris);
+  QObject::connect(&panel, &Panel::firstFramePainted, &mpris,
+                   &Mpris::startMonitoring);
+
+  StartupTrace::Span showSpan("Panel::show");
   panel.show();
+  showSpan.end();
 
   return app.exec();
 }
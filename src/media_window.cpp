@@ -1,391 +1,421 @@
 #include "media_window.hpp"
 
 #include "mpris.hpp"
+#include "tick_scheduler.hpp"
 
 #include "utils.hpp"
 
 #include <LayerShellQt/Shell>
 #include <LayerShellQt/window.h>
 
-#include <QDir>
-#include <QFileInfo>
+#include <QApplication>
 #include <QFrame>
-#include <QHBoxLayout>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QLabel>
-#include <QMessageBox>
-#include <QProcess>
-#include <QScrollArea>
-#include <QTextStream>
-#include <QTimer>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionButton>
+#include <QStyleOptionProgressBar>
 #include <QVBoxLayout>
-#include <QWidget>
 #include <QWindow>
 
-#include <cstdint>
-
-#include <iostream>
-#include <memory>
-#include <optional>
-#include <print>
-
-// PlayerWidget Implementation
-PlayerWidget::PlayerWidget(const QString &playerName, QWidget *parent)
-    : QFrame(parent), m_playerName(playerName) {
-  setupUI();
-  setupControls();
-
-  // Style the widget
-  setFrameStyle(QFrame::Box);
-  setLineWidth(1);
-  setStyleSheet("QFrame { margin: 5px; padding: 5px; border: 1px solid gray; "
-                "border-radius: 5px; }");
-}
-
-void PlayerWidget::setupUI() {
-  // Main horizontal layout (image on the left, everything else on the right)
-  auto *mainLayout = new QHBoxLayout(this);
-  mainLayout->setContentsMargins(8, 8, 8, 8);
-  mainLayout->setSpacing(10);
-
-  // Album Art
-  m_albumArt = new QLabel(this);
-  m_albumArt->setFixedSize(96, 96);
-  m_albumArt->setAlignment(Qt::AlignCenter);
-  m_albumArt->setStyleSheet("border: 1px solid gray;");
-  mainLayout->addWidget(m_albumArt);
-
-  auto *rightLayout = new QVBoxLayout();
-  rightLayout->setSpacing(6);
-
-  m_playerNameLabel = new QLabel(m_playerName, this);
-  m_titleLabel = new QLabel("No track", this);
-  m_artistLabel = new QLabel("No artist", this);
-
-  m_playerNameLabel->setAlignment(Qt::AlignLeft);
-  m_titleLabel->setAlignment(Qt::AlignLeft);
-  m_artistLabel->setAlignment(Qt::AlignLeft);
-
-  // Style labels
-  m_playerNameLabel->setStyleSheet("font-weight: bold; color: #0066cc;");
-  m_titleLabel->setStyleSheet("font-size: 14px;");
-  m_artistLabel->setStyleSheet("font-size: 12px; color: #666;");
-
-  rightLayout->addWidget(m_playerNameLabel);
-  rightLayout->addWidget(m_titleLabel);
-  rightLayout->addWidget(m_artistLabel);
-
-  // Progress bar
-  m_progressBar = new QProgressBar(this);
-  m_progressBar->setMinimum(0);
-  m_progressBar->setMaximum(100);
-  rightLayout->addWidget(m_progressBar);
-
-  // Playback Controls (2 rows)
-  auto *controlsRow1 = new QHBoxLayout();
-  controlsRow1->setSpacing(4);
-
-  m_seekBackBtn = new QPushButton("⏪", this); // -5s
-  m_prevBtn = new QPushButton("⏮", this);
-  m_playPauseBtn = new QPushButton("⏯", this);
-  m_nextBtn = new QPushButton("⏭", this);
-  m_seekFwdBtn = new QPushButton("⏩", this); // +5s
-
-  // Style buttons
-  QString buttonStyle =
-      "QPushButton { min-width: 30px; min-height: 30px; font-size: 16px; }";
-  m_seekBackBtn->setStyleSheet(buttonStyle);
-  m_prevBtn->setStyleSheet(buttonStyle);
-  m_playPauseBtn->setStyleSheet(buttonStyle);
-  m_nextBtn->setStyleSheet(buttonStyle);
-  m_seekFwdBtn->setStyleSheet(buttonStyle);
-
-  controlsRow1->addStretch();
-  controlsRow1->addWidget(m_seekBackBtn);
-  controlsRow1->addWidget(m_prevBtn);
-  controlsRow1->addWidget(m_playPauseBtn);
-  controlsRow1->addWidget(m_nextBtn);
-  controlsRow1->addWidget(m_seekFwdBtn);
-  controlsRow1->addStretch();
-
-  rightLayout->addLayout(controlsRow1);
-
-  auto *controlsRow2 = new QHBoxLayout();
-  controlsRow2->setSpacing(4);
-
-  m_loopBtn = new QPushButton("🔁", this);
-  m_shuffleBtn = new QPushButton("🔀", this);
-
-  m_loopBtn->setStyleSheet(buttonStyle);
-  m_shuffleBtn->setStyleSheet(buttonStyle);
-
-  controlsRow2->addStretch();
-  controlsRow2->addWidget(m_loopBtn);
-  controlsRow2->addWidget(m_shuffleBtn);
-  controlsRow2->addStretch();
-
-  rightLayout->addLayout(controlsRow2);
-
-  // Combine left and right sections
-  mainLayout->addLayout(rightLayout);
-  setLayout(mainLayout);
+namespace {
+
+// Row geometry. The frame's border, radius and the text fonts and colors
+// come from the MediaWindow rules in style.scss.
+constexpr int kFrameMargin = 5;
+constexpr int kFramePadding = 8;
+constexpr int kArtSize = 96;
+constexpr int kSpacing = 10;
+constexpr int kLineGap = 6;
+constexpr int kNameHeight = 24;
+constexpr int kTitleHeight = 22;
+constexpr int kArtistHeight = 20;
+constexpr int kProgressHeight = 16;
+constexpr int kButtonWidth = 40;
+constexpr int kButtonHeight = 32;
+constexpr int kButtonGap = 4;
+constexpr int kGlyphSize = 16;
+constexpr int kFirstRowButtons = 5;
+
+constexpr int kControlsHeight = 2 * kButtonHeight + kLineGap;
+constexpr int kRowHeight = 2 * (kFrameMargin + kFramePadding) + kNameHeight +
+                           kTitleHeight + kArtistHeight + kProgressHeight +
+                           kControlsHeight + 4 * kLineGap;
+
+constexpr size_t kControlCount = static_cast<size_t>(Control::Count);
+
+struct RowLayout {
+  QRect frame, art, name, title, artist, progress, controls;
+};
+
+RowLayout rowLayout(const QRect &row) {
+  RowLayout l;
+  l.frame = row.adjusted(kFrameMargin, kFrameMargin, -kFrameMargin,
+                         -kFrameMargin);
+  QRect inner = l.frame.adjusted(kFramePadding, kFramePadding,
+                                 -kFramePadding, -kFramePadding);
+  l.art = QRect(inner.topLeft(), QSize(kArtSize, kArtSize));
+
+  int x = l.art.right() + 1 + kSpacing;
+  int width = inner.right() + 1 - x;
+  int y = inner.top();
+  auto next = [&](int height) {
+    QRect line(x, y, width, height);
+    y += height + kLineGap;
+    return line;
+  };
+  l.name = next(kNameHeight);
+  l.title = next(kTitleHeight);
+  l.artist = next(kArtistHeight);
+  l.progress = next(kProgressHeight);
+  l.controls = next(kControlsHeight);
+  return l;
 }
 
-void PlayerWidget::setupControls() {
-  // Button functionality
-  connect(m_seekBackBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 position 5-").arg(m_playerName));
-  });
-  connect(m_seekFwdBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 position 5+").arg(m_playerName));
-  });
-  connect(m_prevBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 previous").arg(m_playerName));
-  });
-  connect(m_playPauseBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 play-pause").arg(m_playerName));
-  });
-  connect(m_nextBtn, &QPushButton::clicked, this,
-          [this] { exec(QString("playerctl -p %1 next").arg(m_playerName)); });
-  connect(m_loopBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 loop Toggle").arg(m_playerName));
-  });
-  connect(m_shuffleBtn, &QPushButton::clicked, this, [this] {
-    exec(QString("playerctl -p %1 shuffle Toggle").arg(m_playerName));
-  });
+// Two centred rows: seek/prev/play/next/seek, then loop and shuffle.
+std::array<QRect, kControlCount> buttonRects(const QRect &area) {
+  std::array<QRect, kControlCount> rects;
+  auto placeRow = [&](size_t first, size_t count, int y) {
+    int n = static_cast<int>(count);
+    int total = n * kButtonWidth + (n - 1) * kButtonGap;
+    int x = area.left() + (area.width() - total) / 2;
+    for (size_t i = 0; i < count; ++i) {
+      rects[first + i] = QRect(x, y, kButtonWidth, kButtonHeight);
+      x += kButtonWidth + kButtonGap;
+    }
+  };
+  placeRow(0, kFirstRowButtons, area.top());
+  placeRow(kFirstRowButtons, kControlCount - kFirstRowButtons,
+           area.top() + kButtonHeight + kLineGap);
+  return rects;
 }
 
-void PlayerWidget::updatePlayerData(const QString &title, const QString &artist,
-                                    int position, int length,
-                                    const QString &albumArtPath) {
-  m_titleLabel->setText(title.isEmpty() ? "No track" : title);
-  m_artistLabel->setText(artist.isEmpty() ? "No artist" : artist);
-
-  if (length > 0) {
-    m_progressBar->setValue(position);
-    m_progressBar->setMaximum(length);
-
-    // Format time for display
-    int posMin = position / 60;
-    int posSec = position % 60;
-    int lenMin = length / 60;
-    int lenSec = length % 60;
-
-    m_playerNameLabel->setText(QString("%1 [%2:%3 / %4:%5]")
-                                   .arg(m_playerName)
-                                   .arg(posMin, 2, 10, QChar('0'))
-                                   .arg(posSec, 2, 10, QChar('0'))
-                                   .arg(lenMin, 2, 10, QChar('0'))
-                                   .arg(lenSec, 2, 10, QChar('0')));
-  } else {
-    m_progressBar->setValue(0);
-    m_progressBar->setMaximum(100);
-    m_playerNameLabel->setText(m_playerName);
-  }
-
-  // Update album art if path is provided and different
-  if (!albumArtPath.isEmpty() && QFile::exists(albumArtPath)) {
-    QPixmap newPixmap(albumArtPath);
-    if (!newPixmap.isNull()) {
-      m_albumArtPix = newPixmap.scaled(96, 96, Qt::KeepAspectRatio,
-                                       Qt::SmoothTransformation);
-      m_albumArt->setPixmap(m_albumArtPix);
-    }
+QString controlGlyph(Control control, const QString &status,
+                     const QString &loop) {
+  switch (control) {
+  case Control::SeekBack:
+    return "⏪"; // -5s
+  case Control::Previous:
+    return "⏮";
+  case Control::PlayPause:
+    return status == "Playing" ? "⏸" : "▶";
+  case Control::Next:
+    return "⏭";
+  case Control::SeekForward:
+    return "⏩"; // +5s
+  case Control::Loop:
+    return loop == "Track" ? "🔂" : "🔁";
+  case Control::Shuffle:
+  case Control::Count:
+    break;
   }
+  return "🔀";
 }
 
-// MediaWindow Implementation
-MediaWindow::MediaWindow(QWidget *parent) : QWidget(parent) {
-  setupWindow();
-  setupUI();
-
-  auto *updateTimer = new QTimer(this);
-  connect(updateTimer, &QTimer::timeout, this, &MediaWindow::updateData);
-  updateTimer->start(1000); // Update every second
+bool controlChecked(Control control, const QString &loop, bool shuffle) {
+  if (control == Control::Loop)
+    return loop != "None";
+  if (control == Control::Shuffle)
+    return shuffle;
+  return false;
 }
 
-void MediaWindow::setupWindow() {
-  setWindowTitle("MediaWindow - All Players");
-
-  setWindowFlags(Qt::Window | Qt::WindowStaysOnTopHint |
-                 Qt::FramelessWindowHint | Qt::WindowDoesNotAcceptFocus);
-  setAttribute(Qt::WA_X11NetWmWindowTypeDock, true);
-  setAttribute(Qt::WA_AlwaysShowToolTips, true);
+QString formatTime(int seconds) {
+  return QString("%1:%2")
+      .arg(seconds / 60, 2, 10, QChar('0'))
+      .arg(seconds % 60, 2, 10, QChar('0'));
+}
 
-  // Make it larger to accommodate multiple players
-  setGeometry(0, 0, 500, 600);
+// A hidden widget carrying a class, so the delegate can paint with the
+// font, color and frame the stylesheet gives that class.
+QFrame *styleProbe(const char *className, QWidget *parent) {
+  auto *probe = new QFrame(parent);
+  probe->setProperty("class", className);
+  probe->hide();
+  return probe;
 }
 
-void MediaWindow::setupUI() {
-  auto *mainLayout = new QVBoxLayout(this);
-  mainLayout->setContentsMargins(5, 5, 5, 5);
-  mainLayout->setSpacing(0);
+void drawLine(QPainter *painter, const QRect &rect, const QWidget *probe,
+              const QString &text) {
+  probe->ensurePolished();
+  painter->setFont(probe->font());
+  painter->setPen(probe->palette().color(probe->foregroundRole()));
+  QString elided = probe->fontMetrics().elidedText(text, Qt::ElideRight,
+                                                   rect.width());
+  painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter, elided);
+}
 
-  // Create scroll area
-  m_scrollArea = new QScrollArea(this);
-  m_scrollArea->setWidgetResizable(true);
-  m_scrollArea->setVerticalScrollBarPolicy(
-      Qt::ScrollBarPolicy::ScrollBarAsNeeded);
-  m_scrollArea->setHorizontalScrollBarPolicy(
-      Qt::ScrollBarPolicy::ScrollBarAlwaysOff);
-
-  // Create content widget for scroll area
-  m_scrollContent = new QWidget();
-  m_scrollLayout = new QVBoxLayout(m_scrollContent);
-  m_scrollLayout->setContentsMargins(0, 0, 0, 0);
-  m_scrollLayout->setSpacing(5);
-  m_scrollLayout->addStretch(); // Add stretch at the end
-
-  m_scrollContent->setLayout(m_scrollLayout);
-  m_scrollArea->setWidget(m_scrollContent);
-
-  mainLayout->addWidget(m_scrollArea);
-  setLayout(mainLayout);
+const QStyle *styleFor(const QStyleOptionViewItem &option) {
+  return option.widget ? option.widget->style() : QApplication::style();
 }
 
-PlayerWidget *MediaWindow::findOrCreatePlayerWidget(const QString &playerName) {
-  // Find existing widget
-  for (auto *widget : m_playerWidgets) {
-    if (widget->getPlayerName() == playerName) {
-      return widget;
-    }
+} // namespace
+
+// PlayerControls Implementation
+PlayerControls::PlayerControls(const QString &playerName, Mpris *mpris,
+                               QWidget *parent)
+    : QWidget(parent), m_playerName(playerName), m_mpris(mpris) {
+  for (size_t i = 0; i < kControlCount; ++i) {
+    auto *btn = new QPushButton(this);
+    btn->setProperty("class", "control");
+    btn->setFocusPolicy(Qt::NoFocus);
+    m_buttons[i] = btn;
   }
+  button(Control::Loop)->setCheckable(true);
+  button(Control::Shuffle)->setCheckable(true);
 
-  // Create new widget
-  auto *newWidget = new PlayerWidget(playerName, this);
-  m_playerWidgets.append(newWidget);
+  setupControls();
+  updatePlayerState();
+}
 
-  // Insert before the stretch (which is the last item)
-  m_scrollLayout->insertWidget(m_scrollLayout->count() - 1, newWidget);
+void PlayerControls::resizeEvent(QResizeEvent *event) {
+  QWidget::resizeEvent(event);
+  auto rects = buttonRects(rect());
+  for (size_t i = 0; i < kControlCount; ++i)
+    m_buttons[i]->setGeometry(rects[i]);
+}
+
+void PlayerControls::setupControls() {
+  // Button functionality: async D-Bus calls, never blocking the GUI thread
+  constexpr qint64 seekStepUs = 5'000'000;
+
+  connect(button(Control::SeekBack), &QPushButton::clicked, this,
+          [this] { m_mpris->seek(m_playerName, -seekStepUs); });
+  connect(button(Control::SeekForward), &QPushButton::clicked, this,
+          [this] { m_mpris->seek(m_playerName, seekStepUs); });
+  connect(button(Control::Previous), &QPushButton::clicked, this,
+          [this] { m_mpris->previous(m_playerName); });
+  connect(button(Control::PlayPause), &QPushButton::clicked, this,
+          [this] { m_mpris->playPause(m_playerName); });
+  connect(button(Control::Next), &QPushButton::clicked, this,
+          [this] { m_mpris->next(m_playerName); });
+  connect(button(Control::Loop), &QPushButton::clicked, this, [this] {
+    auto state = m_mpris->getPlayerState(Mpris::busName(m_playerName));
+    QString loop = state ? state->loopStatus : "None";
+    m_mpris->setLoopStatus(m_playerName, loop == "None"       ? "Playlist"
+                                         : loop == "Playlist" ? "Track"
+                                                              : "None");
+  });
+  connect(button(Control::Shuffle), &QPushButton::clicked, this, [this] {
+    auto state = m_mpris->getPlayerState(Mpris::busName(m_playerName));
+    m_mpris->setShuffle(m_playerName, !(state && state->shuffle));
+  });
 
-  return newWidget;
+  // Optimistic updates and their rollbacks both arrive through the model.
+  // Persistent editors are not refreshed by the view, so follow Mpris here.
+  connect(m_mpris, &Mpris::playerStateChanged, this,
+          [this](const QString &playerName) {
+            if (playerName == Mpris::busName(m_playerName))
+              updatePlayerState();
+          });
 }
 
-void MediaWindow::removeUnusedPlayerWidgets(
-    const QStringList &activePlayerNames) {
-  auto it = m_playerWidgets.begin();
-  while (it != m_playerWidgets.end()) {
-    if (!activePlayerNames.contains((*it)->getPlayerName())) {
-      auto *widget = *it;
-      m_scrollLayout->removeWidget(widget);
-      widget->deleteLater();
-      it = m_playerWidgets.erase(it);
-    } else {
-      ++it;
-    }
+void PlayerControls::updatePlayerState() {
+  auto state = m_mpris->getPlayerState(Mpris::busName(m_playerName));
+  QString status = state ? state->playbackStatus : "Stopped";
+  QString loop = state ? state->loopStatus : "None";
+  bool shuffle = state && state->shuffle;
+
+  for (size_t i = 0; i < kControlCount; ++i) {
+    auto control = static_cast<Control>(i);
+    m_buttons[i]->setText(controlGlyph(control, status, loop));
+    if (m_buttons[i]->isCheckable())
+      m_buttons[i]->setChecked(controlChecked(control, loop, shuffle));
   }
 }
 
-QString getActivePlayer() {
-  static QStringList priority = {"spotifyd", "spotify_player", "spotify",
-                                 "firefox", "chrome"};
-
-  QString raw = exec("playerctl", {"-l"});
-  QStringList activePlayers = raw.split('\n', Qt::SkipEmptyParts);
-
-  for (const QString &prefix : priority) {
-    for (const QString &player : activePlayers) {
-      if (player.startsWith(prefix)) {
-        QString status = exec("playerctl", {"-p", player, "status"}).trimmed();
-        if (status == "Playing") {
-          return player;
-        }
-      }
-    }
+// PlayerDelegate Implementation
+PlayerDelegate::PlayerDelegate(Mpris *mpris, AlbumArt *albumArt,
+                               QWidget *parent)
+    : QStyledItemDelegate(parent), m_mpris(mpris), m_albumArt(albumArt),
+      m_frame(styleProbe("player", parent)),
+      m_name(styleProbe("playerName", parent)),
+      m_title(styleProbe("title", parent)),
+      m_artist(styleProbe("artist", parent)) {}
+
+void PlayerDelegate::paint(QPainter *painter,
+                           const QStyleOptionViewItem &option,
+                           const QModelIndex &index) const {
+  RowLayout l = rowLayout(option.rect);
+
+  painter->save();
+  painter->setRenderHint(QPainter::Antialiasing);
+
+  m_frame->ensurePolished();
+  QStyleOption frame;
+  frame.initFrom(m_frame);
+  frame.rect = l.frame;
+  m_frame->style()->drawPrimitive(QStyle::PE_Widget, &frame, painter,
+                                  m_frame);
+
+  // Art is decoded off-thread; the row repaints when artReady arrives.
+  QString artUrl = index.data(PlayerListModel::ArtUrlRole).toString();
+  QPixmap art = m_albumArt->thumbnail(artUrl, kArtSize,
+                                      painter->device()->devicePixelRatioF());
+  if (!art.isNull()) {
+    QRect target(QPoint(), art.deviceIndependentSize().toSize());
+    target.moveCenter(l.art.center());
+    painter->drawPixmap(target, art);
   }
 
-  // Fallback: first matching player by prefix
-  for (const QString &prefix : priority) {
-    for (const QString &player : activePlayers) {
-      if (player.startsWith(prefix)) {
-        return player;
-      }
-    }
+  QString name =
+      Mpris::shortName(index.data(PlayerListModel::NameRole).toString());
+  QString title = index.data(PlayerListModel::TitleRole).toString();
+  QString artist = index.data(PlayerListModel::ArtistRole).toString();
+  int position = index.data(PlayerListModel::PositionRole).toInt();
+  int length = index.data(PlayerListModel::LengthRole).toInt();
+  if (length > 0) {
+    name = QString("%1 [%2 / %3]")
+               .arg(name, formatTime(position), formatTime(length));
   }
 
-  return {}; // empty string if no match
+  drawLine(painter, l.name, m_name, name);
+  drawLine(painter, l.title, m_title, title.isEmpty() ? "No track" : title);
+  drawLine(painter, l.artist, m_artist,
+           artist.isEmpty() ? "No artist" : artist);
+
+  QStyleOptionProgressBar bar;
+  bar.rect = l.progress;
+  bar.palette = option.palette;
+  bar.state = QStyle::State_Enabled | QStyle::State_Horizontal;
+  bar.minimum = 0;
+  bar.maximum = length > 0 ? length : 100;
+  bar.progress = length > 0 ? position : 0;
+  bar.textVisible = false;
+  styleFor(option)->drawControl(QStyle::CE_ProgressBar, &bar, painter,
+                                option.widget);
+
+  // The hovered row has real buttons on top; don't paint under them.
+  auto *view = qobject_cast<const QAbstractItemView *>(option.widget);
+  if (!view || !view->indexWidget(index))
+    paintControls(painter, option, index, l.controls);
+
+  painter->restore();
 }
 
-QString getAlbumArt(QString playerOverride = {}) {
-  QString player = playerOverride;
-  if (player.isEmpty()) {
-    player = getActivePlayer();
+void PlayerDelegate::paintControls(QPainter *painter,
+                                   const QStyleOptionViewItem &option,
+                                   const QModelIndex &index,
+                                   const QRect &area) const {
+  QString status = index.data(PlayerListModel::StatusRole).toString();
+  QString loop = index.data(PlayerListModel::LoopRole).toString();
+  bool shuffle = index.data(PlayerListModel::ShuffleRole).toBool();
+
+  QFont glyphFont = option.font;
+  glyphFont.setPixelSize(kGlyphSize);
+  painter->setFont(glyphFont);
+
+  auto rects = buttonRects(area);
+  for (size_t i = 0; i < kControlCount; ++i) {
+    auto control = static_cast<Control>(i);
+    QStyleOptionButton button;
+    button.rect = rects[i];
+    button.palette = option.palette;
+    button.fontMetrics = QFontMetrics(glyphFont);
+    button.text = controlGlyph(control, status, loop);
+    button.state = QStyle::State_Enabled | QStyle::State_Raised;
+    if (controlChecked(control, loop, shuffle))
+      button.state |= QStyle::State_On;
+    styleFor(option)->drawControl(QStyle::CE_PushButton, &button, painter,
+                                  option.widget);
   }
+}
 
-  QString artUrl =
-      exec("playerctl", {"-p", player, "metadata", "mpris:artUrl"}).trimmed();
-
-  // Fallback: look for paused players
-  if (artUrl.isEmpty()) {
-    QStringList players =
-        exec("playerctl", {"-l"}).split('\n', Qt::SkipEmptyParts);
-    for (const QString &p : players) {
-      QString status = exec("playerctl", {"-p", p, "status"}).trimmed();
-      if (status == "Paused") {
-        QString fallbackArt =
-            exec("playerctl", {"-p", p, "metadata", "mpris:artUrl"}).trimmed();
-        if (!fallbackArt.isEmpty()) {
-          artUrl = fallbackArt;
-          break;
-        }
-      }
-    }
-  }
+QSize PlayerDelegate::sizeHint(const QStyleOptionViewItem &option,
+                               const QModelIndex &) const {
+  // Every row has the same height; the list view stretches it to full width.
+  return {option.rect.width(), kRowHeight};
+}
 
-  if (artUrl.isEmpty()) {
-    return {}; // still nothing
-  }
+QWidget *PlayerDelegate::createEditor(QWidget *parent,
+                                      const QStyleOptionViewItem &,
+                                      const QModelIndex &index) const {
+  return new PlayerControls(index.data(PlayerListModel::NameRole).toString(),
+                            m_mpris, parent);
+}
 
-  if (artUrl.startsWith("file://")) {
-    return artUrl.mid(QString("file://").length());
-  }
+void PlayerDelegate::setEditorData(QWidget *, const QModelIndex &) const {
+  // PlayerControls follows Mpris itself.
+}
 
-  if (artUrl.startsWith("http://") || artUrl.startsWith("https://")) {
-    QString cacheDir = QDir::homePath() + "/.cache/spotifyPictureCache";
-    QDir().mkpath(cacheDir);
-    QString fileName = QFileInfo(QUrl(artUrl).path()).fileName();
-    QString localPath = cacheDir + "/" + fileName;
+void PlayerDelegate::setModelData(QWidget *, QAbstractItemModel *,
+                                  const QModelIndex &) const {
+  // Controls act on the player over D-Bus, never on the model.
+}
 
-    if (!QFile::exists(localPath)) {
-      // Download using wget -c quietly
-      QProcess::execute("wget", {"-c", "-q", artUrl, "-O", localPath});
-    }
+void PlayerDelegate::updateEditorGeometry(QWidget *editor,
+                                          const QStyleOptionViewItem &option,
+                                          const QModelIndex &) const {
+  editor->setGeometry(rowLayout(option.rect).controls);
+}
 
-    return localPath;
-  }
+// MediaWindow Implementation
+MediaWindow::MediaWindow(Mpris *mpris, QWidget *parent)
+    : QWidget(parent), m_mpris(mpris) {
+  m_albumArt = new AlbumArt(this);
+  m_model = new PlayerListModel(m_mpris, this);
+  connect(m_albumArt, &AlbumArt::artReady, m_model,
+          &PlayerListModel::artReady);
 
-  return {}; // unknown format
-}
+  setupWindow();
+  setupUI();
 
-void MediaWindow::updateData() {
-  if (this->isHidden())
-    return;
+  // Progress only moves while the window is on screen.
+  TickScheduler::instance()->add(
+      "media window", 1, 0, this, [this] { m_model->refreshPositions(); },
+      this);
+}
 
-  auto players =
-      exec("playerctl", QStringList() << "-l").split('\n', Qt::SkipEmptyParts);
-  players.removeAll("");
+void MediaWindow::setupWindow() {
+  setWindowTitle("MediaWindow - All Players");
 
-  removeUnusedPlayerWidgets(players);
+  setWindowFlags(Qt::Window | Qt::WindowStaysOnTopHint |
+                 Qt::FramelessWindowHint | Qt::WindowDoesNotAcceptFocus);
+  setAttribute(Qt::WA_X11NetWmWindowTypeDock, true);
+  setAttribute(Qt::WA_AlwaysShowToolTips, true);
 
-  for (const auto &playerName : players) {
-    if (playerName.trimmed().isEmpty())
-      continue;
+  // Make it larger to accommodate multiple players
+  setGeometry(0, 0, 500, 600);
+}
 
-    auto playerData = Mpris::getPlayerData(playerName);
-    auto *playerWidget = findOrCreatePlayerWidget(playerName);
+void MediaWindow::setupUI() {
+  auto *mainLayout = new QVBoxLayout(this);
+  mainLayout->setContentsMargins(5, 5, 5, 5);
+  mainLayout->setSpacing(0);
 
-    auto albumArt = getAlbumArt(playerName);
-    qWarning() << "Album Art: " << albumArt;
+  // Rows are painted by the delegate and only visible ones are painted, so
+  // many players cost no more than the ones on screen.
+  m_view = new QListView(this);
+  m_view->setModel(m_model);
+  m_view->setItemDelegate(new PlayerDelegate(m_mpris, m_albumArt, m_view));
+  m_view->setUniformItemSizes(true);
+  m_view->setSelectionMode(QAbstractItemView::NoSelection);
+  m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  m_view->setFocusPolicy(Qt::NoFocus);
+  m_view->setFrameShape(QFrame::NoFrame);
+  m_view->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+  m_view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  m_view->setMouseTracking(true);
+  connect(m_view, &QAbstractItemView::entered, this,
+          &MediaWindow::showControls);
+
+  mainLayout->addWidget(m_view);
+  setLayout(mainLayout);
+}
 
-    playerWidget->updatePlayerData(playerData.title, playerData.artist,
-                                   playerData.position, playerData.length,
-                                   albumArt);
-  }
+void MediaWindow::showControls(const QModelIndex &index) {
+  // At most one row has live buttons: the one last under the pointer.
+  if (index == m_controlsIndex)
+    return;
+  if (m_controlsIndex.isValid())
+    m_view->closePersistentEditor(m_controlsIndex);
+  m_controlsIndex = index;
+  if (index.isValid())
+    m_view->openPersistentEditor(index);
 }
 
 void MediaWindow::showEvent(QShowEvent *event) {
   QWidget::showEvent(event);
+  m_model->setActive(true); // before the first paint
 
   if (auto *hndl = windowHandle()) {
     hndl->setProperty("_NET_WM_DESKTOP", 0xFFFFFFFF);
@@ -402,4 +432,8 @@ void MediaWindow::showEvent(QShowEvent *event) {
   }
 }
 
-// #include "mediawindow.moc"
+void MediaWindow::hideEvent(QHideEvent *event) {
+  QWidget::hideEvent(event);
+  showControls({});
+  m_model->setActive(false);
+}
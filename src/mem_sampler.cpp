@@ -0,0 +1,77 @@
+#include "mem_sampler.hpp"
+
+#include <charconv>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Indexed by MemKey.
+static constexpr std::array<std::string_view,
+                            static_cast<size_t>(MemKey::Count)>
+    kMemKeys = {
+        "MemTotal",  "MemFree",  "MemAvailable", "Buffers",
+        "Cached",    "SwapCached", "SwapTotal",  "SwapFree",
+        "Zswap",     "Zswapped", "Dirty",        "Writeback",
+        "Shmem",
+};
+
+static_assert(kMemKeys.back() == "Shmem", "kMemKeys must follow MemKey");
+
+static constexpr int lookupKey(std::string_view name) {
+  for (size_t i = 0; i < kMemKeys.size(); ++i) {
+    if (kMemKeys[i] == name)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+static_assert(lookupKey("MemAvailable") ==
+              static_cast<int>(MemKey::MemAvailable));
+
+MemSampler::MemSampler() {
+  m_fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+}
+
+MemSampler::~MemSampler() {
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool MemSampler::sample() {
+  if (m_fd < 0)
+    return false;
+
+  ssize_t n = pread(m_fd, m_buffer.data(), m_buffer.size(), 0);
+  if (n <= 0)
+    return false;
+
+  const char *p = m_buffer.data();
+  const char *end = p + n;
+
+  // Lines look like "MemAvailable:   12345678 kB"
+  while (p < end) {
+    const char *lineEnd = static_cast<const char *>(
+        std::memchr(p, '\n', static_cast<size_t>(end - p)));
+    if (!lineEnd)
+      lineEnd = end;
+
+    const char *colon = static_cast<const char *>(
+        std::memchr(p, ':', static_cast<size_t>(lineEnd - p)));
+    if (colon) {
+      int key = lookupKey({p, static_cast<size_t>(colon - p)});
+      if (key >= 0) {
+        const char *value = colon + 1;
+        while (value < lineEnd && *value == ' ')
+          ++value;
+        uint64_t kb = 0;
+        std::from_chars(value, lineEnd, kb);
+        m_info.kb[static_cast<size_t>(key)] = kb;
+      }
+    }
+
+    p = lineEnd + 1;
+  }
+
+  return true;
+}
@@ -1,145 +1,539 @@
 #include "mpris.hpp"
-#include "utils.hpp"
+
+#include "startup_trace.hpp"
 
 #include <QApplication>
+#include <QDBusArgument>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDBusReply>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <tuple>
 
-QDBusInterface *Mpris::dbusIface = nullptr;
-QTimer *Mpris::timer = nullptr;
-QStringList Mpris::activePlayers = {};
+static const QString kMprisPrefix = "org.mpris.MediaPlayer2.";
+static const QString kMprisPath = "/org/mpris/MediaPlayer2";
+static const QString kPlayerIface = "org.mpris.MediaPlayer2.Player";
+static const QString kPropsIface = "org.freedesktop.DBus.Properties";
 
-std::optional<QString> Mpris::getCurrentLyrics() {
-  auto ret = exec("lyrics-line.sh");
-  return (ret.isEmpty() ? std::nullopt : std::make_optional(ret));
+Mpris::Mpris(QObject *parent) : QObject(parent) {
+  setObjectName("mpris");
+  initializeDBus();
 }
 
-PlayerData Mpris::getPlayerData(const QString &identity) {
-  auto ret = exec(
-                 "playerctl",
-                 QStringList()
-                     << "-p" << identity << "metadata"
-                     << "--format"
-                     << "{{title}}\n{{artist}}\n{{position}}\n{{mpris:length}}")
-                 .split('\n');
+Mpris::~Mpris() {}
 
-  QString title = ret.value(0);
-  QString artist = ret.value(1);
-  int32_t position = ret.value(2).toInt();
-  int32_t length = ret.value(3).toInt();
+void Mpris::cleanup() { stopMonitoring(); }
 
-  return {title, artist, position, length};
+void Mpris::initializeDBus() {
+  // Only names under org.mpris.MediaPlayer2.* wake us up; the bus filters
+  // the rest of NameOwnerChanged traffic via an arg0namespace match.
+  m_watcher = new QDBusServiceWatcher(this);
+  m_watcher->setConnection(QDBusConnection::sessionBus());
+  m_watcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+  connect(m_watcher, &QDBusServiceWatcher::serviceOwnerChanged, this,
+          &Mpris::onServiceOwnerChanged);
 }
 
-Mpris::Mpris(QObject *parent) : QObject(parent) {
-  if (dbusIface or timer) {
+void Mpris::startMonitoring() {
+  if (m_monitoring)
     return;
-  }
+  m_monitoring = true;
+  StartupTrace::Span span("Mpris::startMonitoring");
 
-  initializeDBus();
-  setObjectName("mpris");
-  timer = new QTimer(this);
-  connect(timer, &QTimer::timeout, this, &Mpris::updatePlayers);
+  m_watcher->setWatchedServices({kMprisPrefix + "*"});
+
+  // One path-scoped match covers every player; senders are mapped back to
+  // player names through their unique bus name.
+  QDBusConnection::sessionBus().connect(
+      QString(), kMprisPath, kPropsIface, "PropertiesChanged", this,
+      SLOT(onPropertiesChanged(QString, QVariantMap, QStringList,
+                               QDBusMessage)));
+  QDBusConnection::sessionBus().connect(
+      QString(), kMprisPath, kPlayerIface, "Seeked", this,
+      SLOT(onSeeked(qlonglong, QDBusMessage)));
 
-  // Initial update
+  // Seed the model once; NameOwnerChanged keeps it current afterwards.
   updatePlayers();
+  qDebug() << "Started MPRIS monitoring";
 }
 
-Mpris::~Mpris() {}
+void Mpris::stopMonitoring() {
+  if (!m_monitoring)
+    return;
+  m_monitoring = false;
 
-void Mpris::cleanup() {
-  if (timer) {
-    timer->stop();
+  m_watcher->setWatchedServices({});
+  QDBusConnection::sessionBus().disconnect(
+      QString(), kMprisPath, kPropsIface, "PropertiesChanged", this,
+      SLOT(onPropertiesChanged(QString, QVariantMap, QStringList,
+                               QDBusMessage)));
+  QDBusConnection::sessionBus().disconnect(
+      QString(), kMprisPath, kPlayerIface, "Seeked", this,
+      SLOT(onSeeked(qlonglong, QDBusMessage)));
+
+  m_players.clear();
+  m_playersByOwner.clear();
+  if (!activePlayers.isEmpty()) {
+    activePlayers.clear();
+    emit playersChanged(activePlayers);
   }
-  delete dbusIface;
+  updateActivePlayer();
+  qDebug() << "Stopped MPRIS monitoring";
 }
 
-void Mpris::initializeDBus() {
-  dbusIface =
-      new QDBusInterface("org.freedesktop.DBus", "/org/freedesktop/DBus",
-                         "org.freedesktop.DBus", QDBusConnection::sessionBus());
+void Mpris::updatePlayers() {
+  auto msg = QDBusMessage::createMethodCall(
+      "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus",
+      "ListNames");
+  auto *call = new QDBusPendingCallWatcher(
+      QDBusConnection::sessionBus().asyncCall(msg), this);
+
+  connect(call, &QDBusPendingCallWatcher::finished, this,
+          [this](QDBusPendingCallWatcher *self) {
+            self->deleteLater();
+            StartupTrace::instant("mpris: ListNames reply");
+            QDBusPendingReply<QStringList> reply = *self;
+            if (reply.isError()) {
+              qWarning() << "Failed to get D-Bus names:"
+                         << reply.error().message();
+              return;
+            }
+
+            for (const QString &service : reply.value()) {
+              if (service.startsWith(kMprisPrefix) &&
+                  !m_players.contains(service)) {
+                // Owner is filled in from the GetAll reply sender.
+                addPlayer(service, QString());
+              }
+            }
+          });
 }
 
-QStringList Mpris::fetchActivePlayersFromDBus() {
-  QStringList mprisPlayers;
+void Mpris::onServiceOwnerChanged(const QString &service,
+                                  const QString &oldOwner,
+                                  const QString &newOwner) {
+  if (!service.startsWith(kMprisPrefix))
+    return;
 
-  QDBusReply<QStringList> reply = dbusIface->call("ListNames");
-  if (!reply.isValid()) {
-    qWarning() << "Failed to get D-Bus names:" << reply.error().message();
-    return mprisPlayers;
+  if (newOwner.isEmpty()) {
+    removePlayer(service);
+  } else if (oldOwner.isEmpty() || !m_players.contains(service)) {
+    addPlayer(service, newOwner);
+  } else {
+    // Name handed over to another process: everything we know is stale.
+    setOwner(service, newOwner);
+    fetchPlayerProperties(service);
   }
+}
 
-  QStringList allServices = reply.value();
-  for (const QString &service : allServices) {
-    if (service.startsWith("org.mpris.MediaPlayer2.")) {
-      mprisPlayers << service;
-    }
-  }
+void Mpris::addPlayer(const QString &playerName, const QString &owner) {
+  if (m_players.contains(playerName))
+    return;
+
+  m_players.insert(playerName, PlayerState());
+  setOwner(playerName, owner);
 
-  return mprisPlayers;
+  activePlayers << playerName;
+  emit playersChanged(activePlayers);
+  updateActivePlayer();
+
+  fetchPlayerProperties(playerName);
 }
 
-void Mpris::updatePlayers() {
-  QStringList newPlayers = fetchActivePlayersFromDBus();
+void Mpris::removePlayer(const QString &playerName) {
+  auto it = m_players.find(playerName);
+  if (it == m_players.end())
+    return;
+  m_playersByOwner.remove(it->owner, playerName);
+  m_players.erase(it);
 
-  if (newPlayers != activePlayers) {
-    activePlayers = newPlayers;
-    emit playersChanged(activePlayers);
+  activePlayers.removeAll(playerName);
+  emit playersChanged(activePlayers);
+  updateActivePlayer();
+}
 
-    qDebug() << "Active MPRIS players:" << activePlayers;
+void Mpris::fetchPlayerProperties(const QString &playerName) {
+  auto msg = QDBusMessage::createMethodCall(playerName, kMprisPath,
+                                            kPropsIface, "GetAll");
+  msg << kPlayerIface;
+  auto *call = new QDBusPendingCallWatcher(
+      QDBusConnection::sessionBus().asyncCall(msg), this);
 
-    // Emit metadata for all active players
-    for (const QString &player : activePlayers) {
-      qWarning() << "PLayer: " << player;
-      QVariantMap metadata = getPlayerMetadata(player);
-      if (!metadata.isEmpty()) {
-        emit playerMetadataChanged(player, metadata);
-      }
+  connect(call, &QDBusPendingCallWatcher::finished, this,
+          [this, playerName](QDBusPendingCallWatcher *self) {
+            self->deleteLater();
+            QDBusPendingReply<QVariantMap> reply = *self;
+            if (reply.isError()) {
+              qWarning() << "Failed to get properties from" << playerName
+                         << ":" << reply.error().message();
+              return;
+            }
+
+            auto it = m_players.find(playerName);
+            if (it == m_players.end())
+              return;
+            if (it->owner.isEmpty())
+              setOwner(playerName, self->reply().service());
+
+            applyProperties(playerName, reply.value());
+          });
+}
+
+void Mpris::applyProperties(const QString &playerName,
+                            const QVariantMap &props) {
+  auto it = m_players.find(playerName);
+  if (it == m_players.end())
+    return;
+
+  PlayerState &state = *it;
+  bool metadataChanged = false;
+  bool trackChanged = false;
+  bool stateChanged = false;
+
+  // Freeze the extrapolated position before status or rate move under it.
+  qint64 currentPositionUs = state.positionUs();
+  QString previousStatus = state.playbackStatus;
+  double previousRate = state.rate;
+
+  if (props.contains("Metadata")) {
+    QVariantMap metadata = qdbus_cast<QVariantMap>(props.value("Metadata"));
+    if (metadata != state.metadata) {
+      trackChanged =
+          metadata.value("mpris:trackid") !=
+              state.metadata.value("mpris:trackid") ||
+          metadata.value("xesam:url") != state.metadata.value("xesam:url");
+      state.metadata = metadata;
+      metadataChanged = true;
     }
   }
-}
 
-QVariantMap Mpris::getPlayerMetadata(const QString &playerName) {
-  QVariantMap metadata;
+  auto update = [&stateChanged, &props](const char *key, auto &field,
+                                        auto convert) {
+    if (!props.contains(key))
+      return;
+    auto value = convert(props.value(key));
+    if (value != field) {
+      field = value;
+      stateChanged = true;
+    }
+  };
+  update("PlaybackStatus", state.playbackStatus,
+         [](const QVariant &v) { return v.toString(); });
+  update("Rate", state.rate, [](const QVariant &v) { return v.toDouble(); });
+  update("LoopStatus", state.loopStatus,
+         [](const QVariant &v) { return v.toString(); });
+  update("Shuffle", state.shuffle,
+         [](const QVariant &v) { return v.toBool(); });
+
+  bool statusChanged = state.playbackStatus != previousStatus;
+  if (statusChanged && state.playbackStatus == "Playing")
+    state.lastPlayedSeq = ++m_playSequence;
 
-  QDBusInterface metadataIface(playerName, "/org/mpris/MediaPlayer2",
-                               "org.freedesktop.DBus.Properties",
-                               QDBusConnection::sessionBus());
+  // Copy before emitting: receivers may re-enter and touch m_players.
+  QVariantMap metadata = state.metadata;
 
-  if (!metadataIface.isValid()) {
-    qWarning() << "Failed to create metadata interface for" << playerName;
-    return metadata;
+  if (props.contains("Position")) {
+    anchorPosition(playerName, props.value("Position").toLongLong());
+  } else if (trackChanged) {
+    anchorPosition(playerName, 0);
+    fetchPosition(playerName);
+  } else if (statusChanged) {
+    anchorPosition(playerName, currentPositionUs);
+    fetchPosition(playerName);
+  } else if (state.rate != previousRate) {
+    anchorPosition(playerName, currentPositionUs);
   }
 
-  QDBusReply<QVariant> metaReply =
-      metadataIface.call("Get", "org.mpris.MediaPlayer2.Player", "Metadata");
+  if (metadataChanged)
+    emit playerMetadataChanged(playerName, metadata);
+  if (stateChanged)
+    emit playerStateChanged(playerName);
+  if (metadataChanged || statusChanged)
+    updateActivePlayer();
+}
 
-  if (!metaReply.isValid()) {
-    qWarning() << "Failed to get metadata from" << playerName << ":"
-               << metaReply.error().message();
-    return metadata;
+void Mpris::onPropertiesChanged(const QString &interface,
+                                const QVariantMap &changed,
+                                const QStringList &invalidated,
+                                const QDBusMessage &message) {
+  if (interface != kPlayerIface)
+    return;
+
+  // A connection owning several names serves one object under all of them,
+  // so the change applies to each. Copied: applying may remove players.
+  const QStringList playerNames = playersForOwner(message.service());
+  for (const QString &playerName : playerNames) {
+    applyProperties(playerName, changed);
+
+    // Some players only announce that a property changed without its value.
+    if (!invalidated.isEmpty())
+      fetchPlayerProperties(playerName);
   }
+}
+
+void Mpris::onSeeked(qlonglong positionUs, const QDBusMessage &message) {
+  const QStringList playerNames = playersForOwner(message.service());
+  for (const QString &playerName : playerNames)
+    anchorPosition(playerName, positionUs);
+}
+
+void Mpris::fetchPosition(const QString &playerName) {
+  // Position is never announced by PropertiesChanged, so it is read once per
+  // re-anchor and extrapolated in between.
+  auto msg = QDBusMessage::createMethodCall(playerName, kMprisPath,
+                                            kPropsIface, "Get");
+  msg << kPlayerIface << "Position";
+  auto *call = new QDBusPendingCallWatcher(
+      QDBusConnection::sessionBus().asyncCall(msg), this);
+
+  connect(call, &QDBusPendingCallWatcher::finished, this,
+          [this, playerName](QDBusPendingCallWatcher *self) {
+            self->deleteLater();
+            QDBusPendingReply<QDBusVariant> reply = *self;
+            if (reply.isError())
+              return; // keep extrapolating from the previous anchor
+            anchorPosition(playerName,
+                           reply.value().variant().toLongLong());
+          });
+}
+
+void Mpris::anchorPosition(const QString &playerName, qint64 positionUs) {
+  auto it = m_players.find(playerName);
+  if (it == m_players.end())
+    return;
+
+  it->anchorPositionUs = positionUs;
+  it->anchorTime = std::chrono::steady_clock::now();
+  emit playerPositionChanged(playerName, positionUs);
+}
+
+QStringList Mpris::playersForOwner(const QString &owner) const {
+  if (owner.isEmpty())
+    return {};
+  return m_playersByOwner.values(owner);
+}
+
+void Mpris::setOwner(const QString &playerName, const QString &owner) {
+  auto it = m_players.find(playerName);
+  if (it == m_players.end() || it->owner == owner)
+    return;
+  if (!it->owner.isEmpty())
+    m_playersByOwner.remove(it->owner, playerName);
+  it->owner = owner;
+  if (!owner.isEmpty())
+    m_playersByOwner.insert(owner, playerName);
+}
+
+QVariantMap Mpris::getPlayerMetadata(const QString &playerName) const {
+  auto it = m_players.constFind(playerName);
+  return it == m_players.cend() ? QVariantMap() : it->metadata;
+}
+
+PlayerData Mpris::getPlayerData(const QString &player) const {
+  auto it = m_players.constFind(busName(player));
+  if (it == m_players.cend())
+    return {};
+
+  QString title = it->metadata.value("xesam:title").toString();
+  QString artist =
+      it->metadata.value("xesam:artist").toStringList().join(", ");
+  auto position = static_cast<int32_t>(it->positionUs() / 1'000'000);
+  auto length = static_cast<int32_t>(it->lengthUs() / 1'000'000);
+  QString artUrl = it->metadata.value("mpris:artUrl").toString();
+
+  return {title, artist, position, length, artUrl};
+}
+
+qint64 Mpris::getPosition(const QString &player) const {
+  auto it = m_players.constFind(busName(player));
+  return it == m_players.cend() ? 0 : it->positionUs();
+}
+
+std::optional<PlayerState>
+Mpris::getPlayerState(const QString &playerName) const {
+  auto it = m_players.constFind(playerName);
+  if (it == m_players.cend())
+    return std::nullopt;
+  return *it;
+}
+
+QString Mpris::busName(const QString &player) {
+  return player.startsWith(kMprisPrefix) ? player : kMprisPrefix + player;
+}
+
+QString Mpris::shortName(const QString &player) {
+  return player.startsWith(kMprisPrefix) ? player.mid(kMprisPrefix.size())
+                                         : player;
+}
+
+void Mpris::sendAsync(const QDBusMessage &msg, const QString &playerName,
+                      const QVariantMap &rollback) {
+  auto *call = new QDBusPendingCallWatcher(
+      QDBusConnection::sessionBus().asyncCall(msg), this);
 
-  metadata = qdbus_cast<QVariantMap>(metaReply.value());
+  connect(call, &QDBusPendingCallWatcher::finished, this,
+          [this, playerName, rollback, member = msg.member()](
+              QDBusPendingCallWatcher *self) {
+            self->deleteLater();
+            if (!self->isError())
+              return;
+
+            qWarning() << member << "failed on" << playerName << ":"
+                       << self->error().message();
+            if (!rollback.isEmpty())
+              applyProperties(playerName, rollback);
+          });
+}
+
+void Mpris::callPlayer(const QString &playerName, const QString &method,
+                       const QVariantList &args, const QVariantMap &rollback) {
+  auto msg = QDBusMessage::createMethodCall(playerName, kMprisPath,
+                                            kPlayerIface, method);
+  msg.setArguments(args);
+  sendAsync(msg, playerName, rollback);
+}
 
-  // qDebug() << "Metadata for player:" << playerName;
-  // for (auto it = metadata.constBegin(); it != metadata.constEnd(); ++it) {
-  // qDebug() << "  " << it.key() << ":" << it.value();
-  // }
+void Mpris::setPlayerProperty(const QString &playerName,
+                              const QString &property, const QVariant &value) {
+  auto it = m_players.constFind(playerName);
+  if (it == m_players.cend())
+    return;
+
+  QVariant previous;
+  if (property == "LoopStatus")
+    previous = it->loopStatus;
+  else if (property == "Shuffle")
+    previous = it->shuffle;
+
+  applyProperties(playerName, {{property, value}});
+
+  auto msg = QDBusMessage::createMethodCall(playerName, kMprisPath,
+                                            kPropsIface, "Set");
+  msg << kPlayerIface << property << QVariant::fromValue(QDBusVariant(value));
+  sendAsync(msg, playerName,
+            previous.isValid() ? QVariantMap{{property, previous}}
+                               : QVariantMap());
+}
+
+void Mpris::playPause(const QString &player) {
+  QString playerName = busName(player);
+  auto it = m_players.constFind(playerName);
+  if (it == m_players.cend())
+    return;
 
-  return metadata;
+  QString previous = it->playbackStatus;
+  QString optimistic = previous == "Playing" ? "Paused" : "Playing";
+  applyProperties(playerName, {{"PlaybackStatus", optimistic}});
+  callPlayer(playerName, "PlayPause", {}, {{"PlaybackStatus", previous}});
 }
 
-void Mpris::startMonitoring(int intervalMs) {
-  if (timer) {
-    timer->start(intervalMs);
-    qDebug() << "Started MPRIS monitoring with interval:" << intervalMs << "ms";
+void Mpris::next(const QString &player) { callPlayer(busName(player), "Next"); }
+
+void Mpris::previous(const QString &player) {
+  callPlayer(busName(player), "Previous");
+}
+
+void Mpris::seek(const QString &player, qint64 offsetUs) {
+  callPlayer(busName(player), "Seek",
+             {QVariant::fromValue(static_cast<qlonglong>(offsetUs))});
+}
+
+void Mpris::setPosition(const QString &player, qint64 positionUs) {
+  QString playerName = busName(player);
+  QVariant trackId = getPlayerMetadata(playerName).value("mpris:trackid");
+  if (!trackId.isValid())
+    return; // SetPosition is a no-op without the current track id
+
+  QDBusObjectPath path = trackId.userType() == qMetaTypeId<QDBusObjectPath>()
+                             ? trackId.value<QDBusObjectPath>()
+                             : QDBusObjectPath(trackId.toString());
+  callPlayer(playerName, "SetPosition",
+             {QVariant::fromValue(path),
+              QVariant::fromValue(static_cast<qlonglong>(positionUs))});
+}
+
+void Mpris::setLoopStatus(const QString &player, const QString &status) {
+  setPlayerProperty(busName(player), "LoopStatus", status);
+}
+
+void Mpris::setShuffle(const QString &player, bool shuffle) {
+  setPlayerProperty(busName(player), "Shuffle", shuffle);
+}
+
+void Mpris::setPlayerPriority(const QStringList &prefixes) {
+  m_priority = prefixes;
+  updateActivePlayer();
+}
+
+void Mpris::setPinnedPlayer(const QString &player) {
+  m_pinnedPlayer = player.isEmpty() ? QString() : busName(player);
+  updateActivePlayer();
+}
+
+void Mpris::loadPolicy() {
+  QFile file(QDir::homePath() + "/.config/obolc/mpris.json");
+  if (!file.open(QIODevice::ReadOnly))
+    return;
+
+  QJsonParseError err;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &err);
+  if (err.error != QJsonParseError::NoError) {
+    qWarning() << "mpris.json:" << err.errorString();
+    return;
   }
+
+  QJsonObject object = doc.object();
+  if (object.contains("priority")) {
+    QStringList prefixes;
+    for (const QJsonValue &value : object.value("priority").toArray())
+      prefixes << value.toString();
+    prefixes.removeAll(QString());
+    setPlayerPriority(prefixes);
+  }
+  if (object.contains("pinned"))
+    setPinnedPlayer(object.value("pinned").toString());
 }
 
-void Mpris::stopMonitoring() {
-  if (timer) {
-    timer->stop();
-    qDebug() << "Stopped MPRIS monitoring";
+void Mpris::updateActivePlayer() {
+  QString best;
+
+  if (m_players.contains(m_pinnedPlayer)) {
+    best = m_pinnedPlayer;
+  } else {
+    auto rank = [this](const QString &playerName, const PlayerState &state) {
+      QString name = shortName(playerName);
+      qsizetype priority = m_priority.size();
+      for (qsizetype i = 0; i < m_priority.size(); ++i) {
+        if (name.startsWith(m_priority[i])) {
+          priority = i;
+          break;
+        }
+      }
+      return std::make_tuple(state.playbackStatus == "Playing",
+                             !state.metadata.isEmpty(), -priority,
+                             state.lastPlayedSeq);
+    };
+
+    // activePlayers keeps appearance order, so ties go to the oldest player.
+    std::optional<decltype(rank(QString(), PlayerState()))> bestRank;
+    for (const QString &playerName : activePlayers) {
+      auto r = rank(playerName, m_players.value(playerName));
+      if (!bestRank || r > *bestRank) {
+        bestRank = r;
+        best = playerName;
+      }
+    }
   }
+
+  if (best == m_activePlayer)
+    return;
+  m_activePlayer = best;
+  emit activePlayerChanged(m_activePlayer);
 }
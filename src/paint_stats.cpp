@@ -0,0 +1,51 @@
+#include "paint_stats.hpp"
+
+#include <QChildEvent>
+#include <QPaintEvent>
+
+#include <algorithm>
+
+PaintStats::PaintStats(QObject *parent) : QObject(parent) { m_window.start(); }
+
+void PaintStats::watch(QWidget *root) {
+  root->installEventFilter(this);
+  for (QWidget *child : root->findChildren<QWidget *>())
+    child->installEventFilter(this);
+}
+
+QString PaintStats::sample() {
+  double seconds =
+      std::max(static_cast<double>(m_window.restart()), 1.0) / 1000.0;
+  QString line = QString("%1 relayouts/s, %2 px/s")
+                     .arg(static_cast<double>(m_relayouts) / seconds, 0, 'f', 1)
+                     .arg(static_cast<double>(m_pixels) / seconds, 0, 'f', 0);
+  m_relayouts = 0;
+  m_pixels = 0;
+  return line;
+}
+
+bool PaintStats::eventFilter(QObject *watched, QEvent *event) {
+  switch (event->type()) {
+  case QEvent::LayoutRequest:
+    ++m_relayouts;
+    break;
+  case QEvent::Paint: {
+    auto *widget = static_cast<QWidget *>(watched);
+    double dpr = widget->devicePixelRatioF();
+    quint64 area = 0;
+    for (const QRect &rect : static_cast<QPaintEvent *>(event)->region())
+      area += static_cast<quint64>(rect.width()) *
+              static_cast<quint64>(rect.height());
+    m_pixels += static_cast<quint64>(static_cast<double>(area) * dpr * dpr);
+    break;
+  }
+  case QEvent::ChildAdded:
+    if (auto *child = qobject_cast<QWidget *>(
+            static_cast<QChildEvent *>(event)->child()))
+      child->installEventFilter(this);
+    break;
+  default:
+    break;
+  }
+  return QObject::eventFilter(watched, event);
+}
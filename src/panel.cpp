@@ -1,7 +1,12 @@
 #include "panel.hpp"
 
-#include "media_window.hpp"
+#include "assets.hpp"
+#include "icon_cache.hpp"
 #include "mpris.hpp"
+#include "paint_stats.hpp"
+#include "process_runner.hpp"
+#include "startup_trace.hpp"
+#include "tick_scheduler.hpp"
 #include "tray.hpp"
 
 #include "utils.hpp"
@@ -22,6 +27,7 @@
 #include <QProcess>
 #include <QPushButton>
 #include <QRegularExpression>
+#include <QResizeEvent>
 #include <QScreen>
 #include <QTextStream>
 #include <QTimer>
@@ -31,8 +37,11 @@
 #include <print>
 
 // Panel implementation
-Panel::Panel(QWidget *parent) : QWidget(parent) {
+Panel::Panel(PanelRenderer renderer, QWidget *parent)
+    : QWidget(parent), m_renderer(renderer) {
+  StartupTrace::Span span("Panel::Panel");
 
+  // Started from onFirstFrame; until then the labels stay empty.
   m_systemMonitor = new SystemMonitor(this);
   connect(m_systemMonitor, &SystemMonitor::systemInfoUpdated, this,
           &Panel::updateSystemDisplay);
@@ -40,13 +49,30 @@ Panel::Panel(QWidget *parent) : QWidget(parent) {
   setupWindow();
   setupUI();
   setupTimer();
-  setupMedia();
+
+  m_paintStats = new PaintStats(this);
+  m_paintStats->watch(this);
+  if (qEnvironmentVariableIsSet("OBOLC_PAINT_STATS")) {
+    TickScheduler::instance()->add("paint stats", 1, 0, this, [this] {
+      std::println("{}", m_paintStats->sample().toStdString());
+    });
+  }
 }
 
-void Panel::setupMediaWindow(MediaWindow *mediaWindow) {
+void Panel::setupMediaWindow(Popup *mediaWindow) {
   m_mediaWindow = mediaWindow;
 }
-void Panel::setupMpris(Mpris *mpris) { m_mpris = mpris; }
+void Panel::setupMpris(Mpris *mpris) {
+  m_mpris = mpris;
+  m_lyrics = new Lyrics(mpris, this);
+
+  // The media button is driven by MPRIS and lyric line changes, not a timer.
+  connect(m_lyrics, &Lyrics::currentLineChanged, this, &Panel::updateMedia);
+  connect(m_mpris, &Mpris::playersChanged, this, &Panel::updateMedia);
+  connect(m_mpris, &Mpris::playerMetadataChanged, this, &Panel::updateMedia);
+  connect(m_mpris, &Mpris::activePlayerChanged, this, &Panel::updateMedia);
+  updateMedia();
+}
 
 void Panel::setupWindow() {
   setWindowTitle("Panel");
@@ -69,65 +95,194 @@ static inline QLabel *mkLabelClass(const char *className, QWidget *parent) {
   return _;
 }
 
+// Identical text would still invalidate the label and repaint it.
+template <typename Widget>
+static void setTextIfChanged(Widget *widget, const QString &text) {
+  if (widget->text() != text)
+    widget->setText(text);
+}
+
+// Fixes the label to the width of the widest string it will show and to the
+// bar height. QWidget::updateGeometry() leaves the parent layout alone only
+// for widgets fixed in both directions, so a value going from 9.8% to 10.1%
+// repaints the label but never relayouts the bar.
+static void reserveWidth(QLabel *label, const QString &widest, int height) {
+  QString text = label->text();
+  label->setMinimumSize(0, 0);
+  label->setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+  label->setText(widest);
+  label->setFixedSize(label->sizeHint().width(), height);
+  label->setText(text);
+  label->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+}
+
+// Digits are not necessarily tabular, so fill templates with the widest.
+static QString widestNumber(const QFontMetrics &metrics, QString pattern) {
+  QChar widest = u'0';
+  for (char16_t digit = u'1'; digit <= u'9'; ++digit) {
+    if (metrics.horizontalAdvance(QChar(digit)) >
+        metrics.horizontalAdvance(widest))
+      widest = QChar(digit);
+  }
+  return pattern.replace(u'0', widest);
+}
+
 void Panel::setupUI() {
+  StartupTrace::Span span("Panel::setupUI");
   QHBoxLayout *layout = new QHBoxLayout(this);
-  layout->setContentsMargins(8, 0, 8, 0);
-  layout->setSpacing(6);
+  if (m_renderer == PanelRenderer::Painted) {
+    layout->setContentsMargins(0, 0, 8, 0);
+    layout->setSpacing(6);
+    setupPaintedUI(layout);
+  } else {
+    layout->setContentsMargins(8, 0, 8, 0);
+    layout->setSpacing(6);
+    setupWidgetUI(layout);
+  }
 
-  m_menuButton = new QPushButton(
-      QIcon(QString::fromStdString(getAssetFile("nix.svg").string())), "",
-      this);
-  m_menuButton->setToolTip("Application Menu");
-  m_menuButton->setProperty("class", "start");
+  m_tray = new Tray(this);
+  layout->addWidget(m_tray);
 
-  m_workspaceLabel = mkLabelClass("workspace", this);
-  m_windowLabel = mkLabelClass("window", this);
+  setLayout(layout);
+  reserveNumericWidths();
+}
 
-  layout->addWidget(m_menuButton);
-  layout->addWidget(m_workspaceLabel);
-  layout->addWidget(m_windowLabel);
+void Panel::setupWidgetUI(QHBoxLayout *layout) {
+  auto *menuButton = new QPushButton(this); // icon set in onFirstFrame
+  menuButton->setToolTip("Application Menu");
+  menuButton->setProperty("class", "start");
+  connect(menuButton, &QPushButton::clicked, this, &Panel::onMenuClicked);
+  segment(Segment::Start) = menuButton;
+
+  segment(Segment::Workspace) = mkLabelClass("workspace", this);
+  segment(Segment::Window) = mkLabelClass("window", this);
+
+  layout->addWidget(segment(Segment::Start));
+  layout->addWidget(segment(Segment::Workspace));
+  layout->addWidget(segment(Segment::Window));
+
+  // User scripts from ~/.config/obolc/modules.json
+  QList<CustomModule *> rightModules;
+  for (const CustomModule::Config &config : CustomModule::loadConfig()) {
+    auto *module = new CustomModule(config, this);
+    if (config.left)
+      layout->addWidget(module);
+    else
+      rightModules << module;
+  }
 
   // Center spacer
   layout->addStretch();
 
-  m_mediaBtn = new QPushButton("", this);
-  m_mediaBtn->setFlat(true);
-  m_mediaBtn->setCursor(Qt::PointingHandCursor);
-  m_mediaBtn->setProperty("class", "mediaBtn");
-
-  connect(m_mediaBtn, &QPushButton::clicked, this, &Panel::onMediaClicked);
+  auto *mediaBtn = new QPushButton("", this);
+  mediaBtn->setFlat(true);
+  mediaBtn->setCursor(Qt::PointingHandCursor);
+  mediaBtn->setProperty("class", "mediaBtn");
+  connect(mediaBtn, &QPushButton::clicked, this, &Panel::onMediaClicked);
+  segment(Segment::Media) = mediaBtn;
 
-  layout->addWidget(m_mediaBtn);
+  layout->addWidget(mediaBtn);
 
   layout->addStretch();
 
   // End
-  m_cpuLabel = mkLabelClass("cpu", this);
-  m_memoryLabel = mkLabelClass("memory", this);
-  m_swapLabel = mkLabelClass("swap", this);
-  m_dateLabel = mkLabelClass("date", this);
-  m_timeLabel = mkLabelClass("time", this);
-
-  layout->addWidget(m_cpuLabel);
-  layout->addWidget(m_memoryLabel);
-  layout->addWidget(m_swapLabel);
-  layout->addWidget(m_dateLabel);
-  layout->addWidget(m_timeLabel);
-  layout->addWidget(m_timeLabel);
+  for (CustomModule *module : rightModules)
+    layout->addWidget(module);
+
+  m_cpuBars = new CpuBars(this);
+  m_cpuBars->setProperty("class", "cpuBars");
+  segment(Segment::Cpu) = mkLabelClass("cpu", this);
+  segment(Segment::CpuBars) = m_cpuBars;
+  segment(Segment::Memory) = mkLabelClass("memory", this);
+  segment(Segment::Swap) = mkLabelClass("swap", this);
+  segment(Segment::Date) = mkLabelClass("date", this);
+  segment(Segment::Time) = mkLabelClass("time", this);
+
+  for (Segment s : {Segment::Cpu, Segment::CpuBars, Segment::Memory,
+                    Segment::Swap, Segment::Date, Segment::Time})
+    layout->addWidget(segment(s));
+}
 
-  m_tray = new Tray(this);
-  layout->addWidget(m_tray);
+void Panel::setupPaintedUI(QHBoxLayout *layout) {
+  m_bar = new SegmentBar(this); // start icon set in onFirstFrame
+  m_bar->setSegmentToolTip(Segment::Start, "Application Menu");
+  connect(m_bar, &SegmentBar::clicked, this, [this](Segment clicked) {
+    if (clicked == Segment::Start)
+      onMenuClicked();
+    else if (clicked == Segment::Media)
+      onMediaClicked();
+  });
+  layout->addWidget(m_bar, 1);
+
+  // Scripts keep their own labels, after the painted segments.
+  for (const CustomModule::Config &config : CustomModule::loadConfig())
+    layout->addWidget(new CustomModule(config, this));
+}
 
-  connect(m_menuButton, &QPushButton::clicked, this, &Panel::onMenuClicked);
+void Panel::setSegmentText(Segment s, const QString &text) {
+  if (m_bar) {
+    m_bar->setText(s, text);
+  } else if (auto *label = qobject_cast<QLabel *>(segment(s))) {
+    setTextIfChanged(label, text);
+  } else if (auto *button = qobject_cast<QPushButton *>(segment(s))) {
+    setTextIfChanged(button, text);
+  }
+}
 
-  setLayout(layout);
+void Panel::setSegmentToolTip(Segment s, const QString &text) {
+  if (m_bar)
+    m_bar->setSegmentToolTip(s, text);
+  else
+    segment(s)->setToolTip(text);
+}
+
+void Panel::setSegmentVisible(Segment s, bool visible) {
+  if (m_bar)
+    m_bar->setSegmentVisible(s, visible);
+  else
+    segment(s)->setVisible(visible);
+}
+
+void Panel::reserveNumericWidths() {
+  static constexpr std::pair<Segment, const char *> kNumeric[] = {
+      {Segment::Cpu, "󰍛 100.0%"},
+      {Segment::Memory, "󰍜 100.0%"},
+      {Segment::Swap, "󰟀 100.0%"},
+      {Segment::Time, "00:00:00"},
+  };
+
+  if (m_bar)
+    m_bar->ensurePolished();
+
+  for (auto [s, pattern] : kNumeric) {
+    if (m_bar) {
+      m_bar->reserveWidth(
+          s, widestNumber(m_bar->segmentFontMetrics(s), pattern));
+    } else {
+      auto *label = static_cast<QLabel *>(segment(s));
+      label->ensurePolished();
+      reserveWidth(label, widestNumber(label->fontMetrics(), pattern),
+                   contentsRect().height());
+    }
+  }
+}
+
+void Panel::resizeEvent(QResizeEvent *event) {
+  QWidget::resizeEvent(event);
+
+  // Numeric labels are fixed to the bar height as well.
+  if (event->size().height() != event->oldSize().height())
+    reserveNumericWidths();
 }
 
-void Panel::setupMedia() {
-  m_clockTimer = new QTimer(this);
-  connect(m_clockTimer, &QTimer::timeout, this, &Panel::updateMedia);
-  m_clockTimer->start(1000);
-};
+void Panel::changeEvent(QEvent *event) {
+  QWidget::changeEvent(event);
+
+  // Measure once the labels have been repolished with the new style.
+  if (event->type() == QEvent::StyleChange ||
+      event->type() == QEvent::FontChange)
+    QTimer::singleShot(0, this, &Panel::reserveNumericWidths);
+}
 
 std::optional<std::tuple<QString, QString>>
 getPlayerInfo(Mpris *mpris, std::optional<QString> playerName = std::nullopt) {
@@ -161,13 +316,16 @@ getPlayerInfo(Mpris *mpris, std::optional<QString> playerName = std::nullopt) {
 }
 
 void Panel::updateMedia() {
-  auto lyricsOpt = Mpris::getCurrentLyrics();
-  if (lyricsOpt.has_value()) {
-    m_mediaBtn->setText(lyricsOpt.value());
+  QString player = m_mpris->activePlayer();
+  m_lyrics->setPlayer(player);
+
+  QString line = m_lyrics->currentLine();
+  if (!line.isEmpty()) {
+    setSegmentText(Segment::Media, line);
     return;
   }
 
-  auto playerInfoOpt = getPlayerInfo(m_mpris);
+  auto playerInfoOpt = getPlayerInfo(m_mpris, player);
   QString artist = "..";
   QString title = "..";
   if (playerInfoOpt.has_value()) {
@@ -175,105 +333,199 @@ void Panel::updateMedia() {
     artist = std::get<0>(value);
     title = std::get<1>(value);
   }
-  m_mediaBtn->setText(QString("%1 - %2").arg(artist, title));
+  setSegmentText(Segment::Media, QString("%1 - %2").arg(artist, title));
 }
 
 void Panel::setupTimer() {
-  m_clockTimer = new QTimer(this);
-  connect(m_clockTimer, &QTimer::timeout, this, &Panel::updateTime);
-  m_clockTimer->start(1000); // Update every second
-  updateTime();              // Initial update
+  TickScheduler::instance()->add(
+      "clock", 1, 0, this, [this] { updateTime(); }, this);
+  updateTime(); // Initial update
 }
 
 void Panel::updateTime() {
   QDateTime now = QDateTime::currentDateTime();
-  m_timeLabel->setText(now.toString("hh:mm:ss"));
-  m_dateLabel->setText(now.toString("ddd MMM dd"));
+  setSegmentText(Segment::Time, now.toString("hh:mm:ss"));
+  setSegmentText(Segment::Date, now.toString("ddd MMM dd"));
 }
 
-void Panel::updateSystemDisplay() {
-  SystemMonitor::SystemInfo info = m_systemMonitor->getSystemInfo();
-
-  // Update system metrics
-  m_cpuLabel->setText(
-      QString("󰍛 %1%").arg(QString::number(info.cpuUsage, 'f', 1)));
-
-  m_memoryLabel->setText(
-      QString("󰍜 %1%").arg(QString::number(info.memoryUsage, 'f', 1)));
+static QString formatKiB(uint64_t kib) {
+  auto mib = static_cast<double>(kib) / 1024.0;
+  if (mib >= 1024.0)
+    return QString("%1 GiB").arg(mib / 1024.0, 0, 'f', 1);
+  return QString("%1 MiB").arg(mib, 0, 'f', 0);
+}
 
-  if (info.swapUsage > 0.1) {
-    m_swapLabel->setText(
-        QString("󰟀 %1%").arg(QString::number(info.swapUsage, 'f', 1)));
-    m_swapLabel->show();
-  } else {
-    m_swapLabel->hide();
+static QString memoryTooltip(const MemInfo &mem) {
+  QStringList lines;
+  auto add = [&](const char *label, MemKey key) {
+    lines << QString("%1: %2").arg(label, formatKiB(mem[key]));
+  };
+  add("Total", MemKey::MemTotal);
+  add("Available", MemKey::MemAvailable);
+  add("Free", MemKey::MemFree);
+  add("Cached", MemKey::Cached);
+  add("Buffers", MemKey::Buffers);
+  add("Shmem", MemKey::Shmem);
+  add("Dirty", MemKey::Dirty);
+  add("Writeback", MemKey::Writeback);
+  add("Swap cached", MemKey::SwapCached);
+  if (mem[MemKey::Zswap] > 0 || mem[MemKey::Zswapped] > 0) {
+    add("Zswap pool", MemKey::Zswap);
+    add("Zswapped", MemKey::Zswapped);
   }
+  return lines.join('\n');
+}
 
-  // Update workspace and window info
-  WindowManager wm = m_systemMonitor->getWindowManager();
-  QString wmName;
+static QString windowManagerName(WindowManager wm) {
   switch (wm) {
   case WindowManager::I3:
-    wmName = "i3";
-    break;
+    return "i3";
   case WindowManager::Hyprland:
-    wmName = "Hyprland";
-    break;
+    return "Hyprland";
   case WindowManager::Sway:
-    wmName = "Sway";
-    break;
+    return "Sway";
   default:
-    wmName = "Unknown";
-    break;
+    return "Unknown";
   }
+}
 
-  m_workspaceLabel->setText(
-      QString("%1: %2").arg(wmName, info.currentWorkspace));
+void Panel::updateSystemDisplay() {
+  auto info = m_systemMonitor->getSystemInfo();
+  if (m_lastInfo && m_lastInfo->generation == info->generation)
+    return; // a coalesced notification for a snapshot already shown
+
+  // Only touch the labels whose fields moved since the last snapshot.
+  const SystemInfo *prev = m_lastInfo.get();
+
+  if (!prev || prev->cpuUsage != info->cpuUsage ||
+      prev->cpuSteal != info->cpuSteal || prev->cpuGuest != info->cpuGuest) {
+    setSegmentText(Segment::Cpu, QString("󰍛 %1%").arg(QString::number(
+                                     info->cpuUsage, 'f', 1)));
+    setSegmentToolTip(Segment::Cpu,
+                      QString("Steal: %1%\nGuest: %2%")
+                          .arg(QString::number(info->cpuSteal, 'f', 1),
+                               QString::number(info->cpuGuest, 'f', 1)));
+  }
+  if (!prev || prev->coreUsage != info->coreUsage) {
+    if (m_bar)
+      m_bar->setBars(info->coreUsage);
+    else
+      m_cpuBars->setValues(info->coreUsage);
+  }
 
-  // Truncate long window titles
-  QString windowText = cleanTitle(info.currentWindow);
+  if (!prev || prev->memoryUsage != info->memoryUsage ||
+      prev->memInfo.kb != info->memInfo.kb) {
+    setSegmentText(Segment::Memory, QString("󰍜 %1%").arg(QString::number(
+                                        info->memoryUsage, 'f', 1)));
+    setSegmentToolTip(Segment::Memory, memoryTooltip(info->memInfo));
+  }
+
+  if (!prev || prev->swapUsage != info->swapUsage) {
+    if (info->swapUsage > 0.1) {
+      setSegmentText(Segment::Swap, QString("󰟀 %1%").arg(QString::number(
+                                        info->swapUsage, 'f', 1)));
+    }
+    setSegmentVisible(Segment::Swap, info->swapUsage > 0.1);
+  }
 
-  if (windowText.length() > 40) {
-    windowText = windowText.left(37) + "...";
+  if (!prev || prev->windowManager != info->windowManager ||
+      prev->currentWorkspace != info->currentWorkspace) {
+    setSegmentText(Segment::Workspace,
+                   QString("%1: %2").arg(windowManagerName(info->windowManager),
+                                         info->currentWorkspace));
   }
-  m_windowLabel->setText(windowText);
+
+  if (!prev || prev->currentWindow != info->currentWindow) {
+    // Truncate long window titles
+    QString windowText = cleanTitle(info->currentWindow);
+
+    if (windowText.length() > 40) {
+      windowText = windowText.left(37) + "...";
+    }
+    setSegmentText(Segment::Window, windowText);
+  }
+
+  m_lastInfo = std::move(info);
 }
 
 void Panel::onMediaClicked() {
-  if (m_mediaWindow) {
-    if (m_mediaWindow->isVisible())
-      m_mediaWindow->hide();
-    else
-      m_mediaWindow->show();
-  }
+  if (m_mediaWindow)
+    m_mediaWindow->toggle();
 }
 
 void Panel::onMenuClicked() {
-  SystemMonitor::SystemInfo info = m_systemMonitor->getSystemInfo();
+  auto info = m_systemMonitor->getSystemInfo();
   QMessageBox msg(this);
   msg.setWindowTitle("Panel Info");
   msg.setText(
       QString("Window Manager: %1\nWorkspace: %2\nWindow: %3\nCPU: %4%\nRAM: "
               "%5%\nSwap: %6%")
-          .arg(m_systemMonitor->getWindowManager() == WindowManager::I3 ? "i3"
-               : m_systemMonitor->getWindowManager() == WindowManager::Hyprland
-                   ? "Hyprland"
-                   : "Other")
-          .arg(info.currentWorkspace)
-          .arg(info.currentWindow)
-          .arg(QString::number(info.cpuUsage, 'f', 1))
-          .arg(QString::number(info.memoryUsage, 'f', 1))
-          .arg(QString::number(info.swapUsage, 'f', 1)));
+          .arg(windowManagerName(info->windowManager))
+          .arg(info->currentWorkspace)
+          .arg(info->currentWindow)
+          .arg(QString::number(info->cpuUsage, 'f', 1))
+          .arg(QString::number(info->memoryUsage, 'f', 1))
+          .arg(QString::number(info->swapUsage, 'f', 1)));
+  msg.setDetailedText(
+      "Repaints: " + m_paintStats->sample() + "\n\nWakeups per minute:\n" +
+      TickScheduler::instance()->stats().join('\n') + "\n\nProcesses:\n" +
+      ProcessRunner::instance()->stats().join('\n'));
   msg.setIcon(QMessageBox::Information);
   msg.exec();
 }
 
+void Panel::paintEvent(QPaintEvent *event) {
+  QWidget::paintEvent(event);
+  if (!m_painted) {
+    m_painted = true;
+    QTimer::singleShot(0, this, &Panel::onFirstFrame);
+  }
+}
+
+void Panel::onFirstFrame() {
+  StartupTrace::firstFrame();
+  StartupTrace::Span span("Panel::onFirstFrame");
+
+  // The icon is an SVG, rasterized off-thread after the first frame.
+  connect(IconCache::instance(), &IconCache::iconReady, this,
+          [this](const QString &source) {
+            if (source == Assets::path("nix.svg"))
+              updateStartIcon();
+          });
+  updateStartIcon();
+
+  for (CustomModule *module : findChildren<CustomModule *>())
+    module->start();
+  m_systemMonitor->start();
+
+  emit firstFramePainted();
+}
+
+void Panel::updateStartIcon() {
+  // A cached raster at the current DPR; QIcon would re-render the SVG for
+  // every new scale it is painted at.
+  QPixmap pixmap = IconCache::instance()->pixmap(
+      Assets::path("nix.svg"), kStartIconSize, devicePixelRatioF());
+  if (pixmap.isNull())
+    return; // iconReady calls back
+
+  QIcon icon(pixmap);
+  if (m_bar)
+    m_bar->setIcon(Segment::Start, icon);
+  else
+    static_cast<QPushButton *>(segment(Segment::Start))->setIcon(icon);
+}
+
 void Panel::showEvent(QShowEvent *event) {
   QWidget::showEvent(event);
 
   if (auto *hndl = windowHandle()) {
     hndl->setProperty("_NET_WM_DESKTOP", 0xFFFFFFFF);
 
+    // Moving to a screen with another scale needs a raster at its DPR.
+    connect(hndl, &QWindow::screenChanged, this, &Panel::updateStartIcon,
+            Qt::UniqueConnection);
+
     if (isWayland()) {
       if (LayerShellQt::Window *lsWin = LayerShellQt::Window::get(hndl)) {
         lsWin->setAnchors(LayerShellQt::Window::Anchors::fromInt(
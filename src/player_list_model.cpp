@@ -0,0 +1,236 @@
+#include "player_list_model.hpp"
+
+PlayerListModel::PlayerListModel(Mpris *mpris, QObject *parent)
+    : QAbstractListModel(parent), m_mpris(mpris) {
+  subscribe();
+  syncPlayers(m_mpris->getPlayers());
+}
+
+void PlayerListModel::subscribe() {
+  m_connections = {
+      connect(m_mpris, &Mpris::playersChanged, this,
+              &PlayerListModel::syncPlayers),
+      connect(m_mpris, &Mpris::playerMetadataChanged, this,
+              [this](const QString &player) { updateMetadata(player); }),
+      connect(m_mpris, &Mpris::playerStateChanged, this,
+              &PlayerListModel::updateState),
+      connect(m_mpris, &Mpris::playerPositionChanged, this,
+              [this](const QString &player) { updatePosition(player); }),
+      connect(m_mpris, &Mpris::activePlayerChanged, this,
+              &PlayerListModel::moveToTop),
+  };
+}
+
+void PlayerListModel::setActive(bool active) {
+  if (active == !m_connections.isEmpty())
+    return;
+
+  if (!active) {
+    for (const auto &connection : m_connections)
+      disconnect(connection);
+    m_connections.clear();
+    return;
+  }
+
+  subscribe();
+  syncPlayers(m_mpris->getPlayers());
+  for (const Row &row : std::as_const(m_rows)) {
+    updateMetadata(row.name);
+    updateState(row.name);
+  }
+}
+
+int PlayerListModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+QVariant PlayerListModel::data(const QModelIndex &index, int role) const {
+  if (!checkIndex(index, CheckIndexOption::IndexIsValid))
+    return {};
+
+  const Row &row = m_rows[index.row()];
+  switch (role) {
+  case Qt::DisplayRole:
+  case TitleRole:
+    return row.title;
+  case NameRole:
+    return row.name;
+  case ArtistRole:
+    return row.artist;
+  case ArtUrlRole:
+    return row.artUrl;
+  case PositionRole:
+    return row.position;
+  case LengthRole:
+    return row.length;
+  case StatusRole:
+    return row.status;
+  case LoopRole:
+    return row.loop;
+  case ShuffleRole:
+    return row.shuffle;
+  default:
+    return {};
+  }
+}
+
+QHash<int, QByteArray> PlayerListModel::roleNames() const {
+  return {
+      {NameRole, "name"},         {TitleRole, "title"},
+      {ArtistRole, "artist"},     {ArtUrlRole, "artUrl"},
+      {PositionRole, "position"}, {LengthRole, "length"},
+      {StatusRole, "status"},     {LoopRole, "loop"},
+      {ShuffleRole, "shuffle"},
+  };
+}
+
+void PlayerListModel::refreshPositions() {
+  for (int i = 0; i < m_rows.size(); ++i) {
+    if (m_rows[i].status == "Playing" && readPosition(m_rows[i]))
+      emitRowChanged(i, {PositionRole});
+  }
+}
+
+void PlayerListModel::artReady(const QString &url) {
+  for (int i = 0; i < m_rows.size(); ++i) {
+    if (m_rows[i].artUrl == url)
+      emitRowChanged(i, {ArtUrlRole});
+  }
+}
+
+void PlayerListModel::syncPlayers(const QStringList &players) {
+  // Removals first, from the bottom so earlier rows keep their numbers.
+  for (auto i = m_rows.size() - 1; i >= 0; --i) {
+    if (players.contains(m_rows[i].name))
+      continue;
+    beginRemoveRows({}, static_cast<int>(i), static_cast<int>(i));
+    m_rows.remove(i);
+    endRemoveRows();
+  }
+  reindex(0);
+
+  QList<Row> added;
+  for (const QString &player : players) {
+    if (m_index.contains(player))
+      continue;
+    Row row;
+    row.name = player;
+    readMetadata(row);
+    readState(row);
+    readPosition(row);
+    added << row;
+  }
+
+  if (!added.isEmpty()) {
+    auto first = static_cast<int>(m_rows.size());
+    beginInsertRows({}, first, first + static_cast<int>(added.size()) - 1);
+    m_rows.append(added);
+    reindex(first);
+    endInsertRows();
+  }
+
+  moveToTop(m_mpris->activePlayer());
+}
+
+void PlayerListModel::updateMetadata(const QString &player) {
+  int row = rowOf(player);
+  if (row < 0)
+    return;
+  Row &r = m_rows[row];
+  bool metadata = readMetadata(r);
+  bool position = readPosition(r);
+
+  QList<int> roles;
+  if (metadata)
+    roles << TitleRole << ArtistRole << ArtUrlRole << LengthRole;
+  if (position)
+    roles << PositionRole;
+  if (!roles.isEmpty())
+    emitRowChanged(row, roles);
+}
+
+void PlayerListModel::updateState(const QString &player) {
+  int row = rowOf(player);
+  if (row < 0)
+    return;
+  Row &r = m_rows[row];
+  bool state = readState(r);
+  bool position = readPosition(r); // status changes re-anchor the position
+
+  QList<int> roles;
+  if (state)
+    roles << StatusRole << LoopRole << ShuffleRole;
+  if (position)
+    roles << PositionRole;
+  if (!roles.isEmpty())
+    emitRowChanged(row, roles);
+}
+
+void PlayerListModel::updatePosition(const QString &player) {
+  int row = rowOf(player);
+  if (row >= 0 && readPosition(m_rows[row]))
+    emitRowChanged(row, {PositionRole});
+}
+
+void PlayerListModel::moveToTop(const QString &player) {
+  int row = rowOf(player);
+  if (row <= 0)
+    return;
+  beginMoveRows({}, row, row, {}, 0);
+  m_rows.move(row, 0);
+  reindex(0);
+  endMoveRows();
+}
+
+void PlayerListModel::reindex(int from) {
+  for (auto i = static_cast<qsizetype>(from); i < m_rows.size(); ++i)
+    m_index.insert(m_rows[i].name, static_cast<int>(i));
+
+  // Drop names that no longer have a row.
+  if (m_index.size() != m_rows.size()) {
+    for (auto it = m_index.begin(); it != m_index.end();) {
+      if (it.value() >= m_rows.size() || m_rows[it.value()].name != it.key())
+        it = m_index.erase(it);
+      else
+        ++it;
+    }
+  }
+}
+
+void PlayerListModel::emitRowChanged(int row, const QList<int> &roles) {
+  QModelIndex idx = index(row);
+  emit dataChanged(idx, idx, roles);
+}
+
+bool PlayerListModel::readMetadata(Row &row) const {
+  PlayerData data = m_mpris->getPlayerData(row.name);
+  if (data.title == row.title && data.artist == row.artist &&
+      data.artUrl == row.artUrl && data.length == row.length)
+    return false;
+  row.title = data.title;
+  row.artist = data.artist;
+  row.artUrl = data.artUrl;
+  row.length = data.length;
+  return true;
+}
+
+bool PlayerListModel::readState(Row &row) const {
+  auto state = m_mpris->getPlayerState(row.name);
+  if (!state.has_value())
+    return false;
+  if (state->playbackStatus == row.status && state->loopStatus == row.loop &&
+      state->shuffle == row.shuffle)
+    return false;
+  row.status = state->playbackStatus;
+  row.loop = state->loopStatus;
+  row.shuffle = state->shuffle;
+  return true;
+}
+
+bool PlayerListModel::readPosition(Row &row) const {
+  auto seconds = static_cast<int>(m_mpris->getPosition(row.name) / 1'000'000);
+  if (seconds == row.position)
+    return false;
+  row.position = seconds;
+  return true;
+}
@@ -0,0 +1,59 @@
+#include "popup.hpp"
+
+#include <QEvent>
+
+Popup::Popup(Factory factory, QObject *parent)
+    : QObject(parent), m_factory(std::move(factory)) {
+  m_idle = new QTimer(this);
+  m_idle->setSingleShot(true);
+  connect(m_idle, &QTimer::timeout, this, &Popup::release);
+}
+
+Popup::~Popup() { delete m_widget; }
+
+void Popup::show() {
+  if (!m_widget) {
+    m_widget = m_factory();
+    m_widget->installEventFilter(this);
+  }
+  m_widget->show();
+}
+
+void Popup::hide() {
+  if (m_widget)
+    m_widget->hide();
+}
+
+void Popup::toggle() {
+  if (isVisible())
+    hide();
+  else
+    show();
+}
+
+int Popup::idleSeconds() {
+  static const int seconds = [] {
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue("OBOLC_POPUP_IDLE_SEC", &ok);
+    return ok ? value : kDefaultIdleSec;
+  }();
+  return seconds;
+}
+
+bool Popup::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_widget) {
+    if (event->type() == QEvent::Show) {
+      m_idle->stop();
+    } else if (event->type() == QEvent::Hide && idleSeconds() >= 0) {
+      m_idle->start(idleSeconds() * 1000);
+    }
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+void Popup::release() {
+  if (!m_widget || m_widget->isVisible())
+    return;
+  m_widget->deleteLater();
+  m_widget = nullptr;
+}
@@ -0,0 +1,155 @@
+#include "process_runner.hpp"
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <algorithm>
+
+ProcessRunner *ProcessRunner::instance() {
+  static auto *runner = new ProcessRunner(QCoreApplication::instance());
+  return runner;
+}
+
+ProcessRunner::ProcessRunner(QObject *parent) : QObject(parent) {}
+
+QString ProcessRunner::jobKey(const QString &program, const QStringList &args) {
+  // NUL cannot appear in argv, so the key is unambiguous.
+  return program + QChar(0) + args.join(QChar(0));
+}
+
+void ProcessRunner::run(const QString &program, const QStringList &args,
+                        QObject *context, Callback onDone, Options options) {
+  QString key = jobKey(program, args);
+
+  auto cached = m_cache.constFind(key);
+  if (cached != m_cache.cend() && cached->age.elapsed() < cached->ttlMs) {
+    ++m_cacheHits;
+    onDone(cached->result);
+    return;
+  }
+
+  Waiter waiter{context, std::move(onDone)};
+
+  auto running = m_jobs.find(key);
+  if (running != m_jobs.end()) {
+    ++m_coalesced;
+    running->waiters << std::move(waiter);
+    // A caller that wants the result cached longer gets its way.
+    running->options.cacheTtlMs =
+        std::max(running->options.cacheTtlMs, options.cacheTtlMs);
+    return;
+  }
+
+  Job job;
+  job.program = program;
+  job.args = args;
+  job.options = options;
+  job.waiters << std::move(waiter);
+  m_jobs.insert(key, std::move(job));
+  m_queue.enqueue(key);
+  startQueued();
+}
+
+void ProcessRunner::startQueued() {
+  while (m_running < kMaxConcurrent && !m_queue.isEmpty())
+    spawn(m_queue.dequeue());
+}
+
+void ProcessRunner::spawn(const QString &key) {
+  Job &job = m_jobs[key];
+  ++m_running;
+  ++m_spawned;
+
+  auto *process = new QProcess(this);
+  job.process = process;
+  process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+  auto *deadline = new QTimer(process);
+  deadline->setSingleShot(true);
+  connect(deadline, &QTimer::timeout, process, [this, key, process] {
+    auto it = m_jobs.find(key);
+    if (it == m_jobs.end() || it->process != process)
+      return; // already finished, waiting for deleteLater
+    it->timedOut = true;
+    process->kill(); // finished() follows
+  });
+
+  connect(process, &QProcess::finished, this,
+          [this, key, process](int exitCode, QProcess::ExitStatus status) {
+            ProcessResult result;
+            result.exitCode = status == QProcess::NormalExit ? exitCode : -1;
+            result.timedOut = m_jobs.value(key).timedOut;
+            result.stdOut = process->readAllStandardOutput();
+            finish(key, std::move(result));
+          });
+  connect(process, &QProcess::errorOccurred, this,
+          [this, key](QProcess::ProcessError error) {
+            // Every other error is followed by finished().
+            if (error != QProcess::FailedToStart)
+              return;
+            ProcessResult result;
+            result.failedToStart = true;
+            finish(key, std::move(result));
+          });
+
+  job.started.start();
+  deadline->start(job.options.timeoutMs);
+  process->start(job.program, job.args);
+}
+
+void ProcessRunner::finish(const QString &key, ProcessResult result) {
+  Job job = m_jobs.take(key);
+  job.process->disconnect(this);
+  job.process->deleteLater();
+  --m_running;
+
+  qint64 latencyMs = job.started.elapsed();
+  m_totalLatencyMs += latencyMs;
+  m_maxLatencyMs = std::max(m_maxLatencyMs, latencyMs);
+  if (result.timedOut)
+    ++m_timedOut;
+  if (!result.ok())
+    ++m_failed;
+
+  if (job.options.cacheTtlMs > 0 && result.ok()) {
+    pruneCache();
+    CacheEntry entry{result, {}, job.options.cacheTtlMs};
+    entry.age.start();
+    m_cache.insert(key, std::move(entry));
+  }
+
+  // Start the next child before running callbacks, which may queue more.
+  startQueued();
+
+  for (const Waiter &waiter : job.waiters) {
+    if (waiter.context)
+      waiter.onDone(result);
+  }
+}
+
+void ProcessRunner::pruneCache() {
+  for (auto it = m_cache.begin(); it != m_cache.end();) {
+    if (it->age.elapsed() >= it->ttlMs)
+      it = m_cache.erase(it);
+    else
+      ++it;
+  }
+}
+
+QStringList ProcessRunner::stats() const {
+  quint64 finished = m_spawned - static_cast<quint64>(m_running);
+  double meanMs = finished > 0 ? static_cast<double>(m_totalLatencyMs) /
+                                     static_cast<double>(finished)
+                               : 0.0;
+  return {
+      QString("Spawned: %1 (%2 running, %3 queued)")
+          .arg(m_spawned)
+          .arg(m_running)
+          .arg(m_queue.size()),
+      QString("Coalesced: %1, cache hits: %2").arg(m_coalesced).arg(m_cacheHits),
+      QString("Failed: %1 (%2 timed out)").arg(m_failed).arg(m_timedOut),
+      QString("Latency: %1 ms mean, %2 ms max")
+          .arg(meanMs, 0, 'f', 1)
+          .arg(m_maxLatencyMs),
+  };
+}
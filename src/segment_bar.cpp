@@ -0,0 +1,394 @@
+#include "segment_bar.hpp"
+
+#include <QCoreApplication>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QStyleOption>
+#include <QToolTip>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// The class each segment's widget carries in the widget renderer.
+constexpr std::array<const char *, static_cast<size_t>(Segment::Count)>
+    kClasses = {"start", "workspace", "window", "mediaBtn", "cpu",
+                "cpuBars", "memory", "swap", "date", "time"};
+
+constexpr Segment kLeft[] = {Segment::Start, Segment::Workspace,
+                             Segment::Window};
+constexpr Segment kRight[] = {Segment::Cpu,  Segment::CpuBars, Segment::Memory,
+                              Segment::Swap, Segment::Date,    Segment::Time};
+
+} // namespace
+
+SegmentBar::SegmentBar(QWidget *parent) : QWidget(parent) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+  setMouseTracking(true);
+  createProbes();
+  reloadStyles();
+}
+
+void SegmentBar::setText(Segment segment, const QString &text) {
+  Item &it = item(segment);
+  if (it.text == text)
+    return;
+  it.text = text;
+  if (auto *button = qobject_cast<QPushButton *>(it.probe))
+    button->setText(text);
+  prepareText(segment);
+
+  if (measure(segment) != it.contentWidth)
+    relayout();
+  else
+    update(it.box);
+}
+
+void SegmentBar::setSegmentToolTip(Segment segment, const QString &text) {
+  item(segment).toolTip = text;
+}
+
+void SegmentBar::setSegmentVisible(Segment segment, bool visible) {
+  Item &it = item(segment);
+  if (it.visible == visible)
+    return;
+  it.visible = visible;
+  relayout();
+}
+
+void SegmentBar::setIcon(Segment segment, const QIcon &icon) {
+  Item &it = item(segment);
+  it.icon = icon;
+  if (auto *button = qobject_cast<QPushButton *>(it.probe))
+    button->setIcon(icon);
+
+  if (measure(segment) != it.contentWidth)
+    relayout();
+  else
+    update(it.box);
+}
+
+void SegmentBar::setBars(const QList<double> &values) {
+  // Bars are a few pixels tall; skip repaints that would not move a pixel.
+  bool resized = values.size() != m_bars.size();
+  bool changed = resized;
+  for (qsizetype i = 0; !changed && i < values.size(); ++i)
+    changed = std::abs(values[i] - m_bars[i]) >= 1.0;
+  if (!changed)
+    return;
+
+  m_bars = values;
+  if (resized)
+    relayout();
+  else
+    update(item(Segment::CpuBars).box);
+}
+
+void SegmentBar::reserveWidth(Segment segment, const QString &widest) {
+  Item &it = item(segment);
+  it.reservedText = widest;
+  it.reservedWidth = segmentFontMetrics(segment).horizontalAdvance(widest);
+  relayout();
+}
+
+QFontMetrics SegmentBar::segmentFontMetrics(Segment segment) const {
+  return QFontMetrics(item(segment).font);
+}
+
+bool SegmentBar::isButton(Segment segment) {
+  return segment == Segment::Start || segment == Segment::Media;
+}
+
+void SegmentBar::createProbes() {
+  for (size_t i = 0; i < m_items.size(); ++i) {
+    auto segment = static_cast<Segment>(i);
+    QWidget *probe = nullptr;
+    if (isButton(segment)) {
+      auto *button = new QPushButton(this);
+      button->setFlat(segment == Segment::Media);
+      probe = button;
+    } else {
+      probe = new QLabel(this);
+    }
+    // Never shown; only polished, measured and handed to the style.
+    probe->setProperty("class", kClasses[i]);
+    probe->hide();
+    m_items[i].probe = probe;
+  }
+}
+
+void SegmentBar::reloadStyles() {
+  for (size_t i = 0; i < m_items.size(); ++i)
+    loadStyle(static_cast<Segment>(i));
+  relayout();
+}
+
+void SegmentBar::loadStyle(Segment segment) {
+  Item &it = item(segment);
+  QWidget *probe = it.probe;
+
+  // Repolish explicitly: the application repolishes widgets in no particular
+  // order, and the probes must reflect the new rules before we read them.
+  // The StyleChange event drops QPushButton's cached size hint.
+  probe->style()->unpolish(probe);
+  probe->style()->polish(probe);
+  QEvent styleChange(QEvent::StyleChange);
+  QCoreApplication::sendEvent(probe, &styleChange);
+
+  it.font = probe->font();
+  it.color = probe->palette().color(probe->foregroundRole());
+  it.maxWidth = probe->maximumWidth();
+
+  if (!isButton(segment)) {
+    // What QFrame would report as its frame widths for this rule.
+    static constexpr int kProbeSize = 1000;
+    QStyleOptionFrame opt;
+    opt.initFrom(probe);
+    opt.rect = QRect(0, 0, kProbeSize, kProbeSize);
+    QRect contents = probe->style()->subElementRect(
+        QStyle::SE_ShapedFrameContents, &opt, probe);
+    it.insets = QMargins(contents.left(), contents.top(),
+                         kProbeSize - 1 - contents.right(),
+                         kProbeSize - 1 - contents.bottom()) +
+                probe->contentsMargins();
+  }
+
+  if (!it.reservedText.isEmpty()) {
+    it.reservedWidth =
+        segmentFontMetrics(segment).horizontalAdvance(it.reservedText);
+  }
+  prepareText(segment);
+}
+
+void SegmentBar::prepareText(Segment segment) {
+  Item &it = item(segment);
+  if (isButton(segment))
+    return; // drawn by the style from the probe's text
+
+  QString shown = it.text;
+  if (it.maxWidth < QWIDGETSIZE_MAX) {
+    int available = it.maxWidth - it.insets.left() - it.insets.right();
+    shown = QFontMetrics(it.font).elidedText(shown, Qt::ElideRight,
+                                             std::max(0, available));
+  }
+
+  it.staticText.setTextFormat(Qt::PlainText);
+  it.staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+  it.staticText.setText(shown);
+  it.staticText.prepare(QTransform(), it.font);
+}
+
+int SegmentBar::measure(Segment segment) const {
+  const Item &it = item(segment);
+  if (isButton(segment))
+    return it.probe->sizeHint().width(); // whole button, as the layout sees it
+  if (segment == Segment::CpuBars) {
+    auto count = static_cast<int>(m_bars.size());
+    return count * kBarWidth + std::max(0, count - 1) * kBarGap;
+  }
+
+  auto textWidth = static_cast<int>(std::ceil(it.staticText.size().width()));
+  return std::max(textWidth, it.reservedWidth);
+}
+
+void SegmentBar::relayout() {
+  auto place = [this](Segment segment, int x) {
+    Item &it = item(segment);
+    it.contentWidth = measure(segment);
+
+    // Labels stretch to the bar height; buttons keep their natural height.
+    int boxWidth = it.contentWidth;
+    int boxHeight = height();
+    if (isButton(segment)) {
+      boxHeight = std::min(boxHeight, it.probe->sizeHint().height());
+    } else {
+      boxWidth = std::min(boxWidth + it.insets.left() + it.insets.right(),
+                          it.maxWidth);
+    }
+    it.box = QRect(x, (height() - boxHeight) / 2, boxWidth, boxHeight);
+    return boxWidth;
+  };
+
+  int left = kEdge;
+  for (Segment segment : kLeft) {
+    if (item(segment).visible)
+      left += place(segment, left) + kSpacing;
+  }
+
+  int right = width() - kEdge;
+  for (auto it = std::rbegin(kRight); it != std::rend(kRight); ++it) {
+    if (!item(*it).visible)
+      continue;
+    int outer = place(*it, 0);
+    right -= outer;
+    item(*it).box.moveLeft(right);
+    right -= kSpacing;
+  }
+
+  // Centred between the two groups, like the two stretches in the layout.
+  int outer = place(Segment::Media, 0);
+  int mediaX = left + std::max(0, (right - left - outer) / 2);
+  item(Segment::Media).box.moveLeft(mediaX);
+
+  update();
+}
+
+Segment SegmentBar::segmentAt(const QPoint &pos) const {
+  for (size_t i = 0; i < m_items.size(); ++i) {
+    if (m_items[i].visible && m_items[i].box.contains(pos))
+      return static_cast<Segment>(i);
+  }
+  return Segment::Count;
+}
+
+void SegmentBar::setHovered(Segment segment) {
+  if (segment == m_hovered)
+    return;
+  // Any class may have a :hover rule.
+  if (m_hovered != Segment::Count)
+    update(item(m_hovered).box);
+  if (segment != Segment::Count)
+    update(item(segment).box);
+  m_hovered = segment;
+
+  bool clickable = segment == Segment::Start || segment == Segment::Media;
+  if (clickable)
+    setCursor(Qt::PointingHandCursor);
+  else
+    unsetCursor();
+}
+
+bool SegmentBar::event(QEvent *event) {
+  if (event->type() == QEvent::ToolTip) {
+    auto *help = static_cast<QHelpEvent *>(event);
+    Segment segment = segmentAt(help->pos());
+    if (segment != Segment::Count && !item(segment).toolTip.isEmpty()) {
+      QToolTip::showText(help->globalPos(), item(segment).toolTip, this,
+                         item(segment).box);
+    } else {
+      QToolTip::hideText();
+      event->ignore();
+    }
+    return true;
+  }
+  return QWidget::event(event);
+}
+
+void SegmentBar::paintEvent(QPaintEvent *event) {
+  // No background of our own: the panel shows through between segments,
+  // exactly as it does between the label widgets.
+  QPainter painter(this);
+  for (size_t i = 0; i < m_items.size(); ++i) {
+    const Item &it = m_items[i];
+    if (it.visible && it.box.intersects(event->rect()))
+      paintSegment(painter, static_cast<Segment>(i));
+  }
+}
+
+void SegmentBar::paintSegment(QPainter &painter, Segment segment) {
+  if (isButton(segment)) {
+    paintButton(painter, segment);
+    return;
+  }
+
+  // Background and border as the probe's QLabel would draw them here.
+  const Item &it = item(segment);
+  QStyleOption opt;
+  opt.initFrom(it.probe);
+  opt.rect = it.box;
+  if (segment == m_hovered)
+    opt.state |= QStyle::State_MouseOver;
+  style()->drawPrimitive(QStyle::PE_Widget, &opt, &painter, it.probe);
+
+  QRect content = it.box.marginsRemoved(it.insets);
+  if (segment == Segment::CpuBars) {
+    int x = content.left();
+    for (double value : m_bars) {
+      auto barHeight = static_cast<int>(std::lround(
+          content.height() * std::clamp(value, 0.0, 100.0) / 100.0));
+      painter.fillRect(x, content.bottom() - barHeight + 1, kBarWidth,
+                       barHeight, it.color);
+      x += kBarWidth + kBarGap;
+    }
+    return;
+  }
+
+  QSizeF size = it.staticText.size();
+  double x = content.left();
+  if (it.reservedWidth > 0)
+    x = content.right() + 1 - size.width(); // numbers align right
+  double y = content.top() + (content.height() - size.height()) / 2.0;
+
+  painter.save();
+  painter.setClipRect(content);
+  painter.setFont(it.font);
+  painter.setPen(it.color);
+  painter.drawStaticText(QPointF(x, y), it.staticText);
+  painter.restore();
+}
+
+void SegmentBar::paintButton(QPainter &painter, Segment segment) {
+  // Same option QPushButton::initStyleOption would build for the probe.
+  const Item &it = item(segment);
+  auto *button = static_cast<QPushButton *>(it.probe);
+  QStyleOptionButton opt;
+  opt.initFrom(button);
+  opt.rect = it.box;
+  opt.text = button->text();
+  opt.icon = button->icon();
+  opt.iconSize = button->iconSize();
+  if (button->isFlat())
+    opt.features |= QStyleOptionButton::Flat;
+  if (m_pressed == segment && m_hovered == segment)
+    opt.state |= QStyle::State_Sunken;
+  else if (!button->isFlat())
+    opt.state |= QStyle::State_Raised;
+  if (segment == m_hovered)
+    opt.state |= QStyle::State_MouseOver;
+  style()->drawControl(QStyle::CE_PushButton, &opt, &painter, button);
+}
+
+void SegmentBar::resizeEvent(QResizeEvent *event) {
+  QWidget::resizeEvent(event);
+  relayout();
+}
+
+void SegmentBar::changeEvent(QEvent *event) {
+  QWidget::changeEvent(event);
+  if (event->type() == QEvent::FontChange ||
+      event->type() == QEvent::StyleChange)
+    reloadStyles();
+}
+
+void SegmentBar::mouseMoveEvent(QMouseEvent *event) {
+  setHovered(segmentAt(event->position().toPoint()));
+}
+
+void SegmentBar::mousePressEvent(QMouseEvent *event) {
+  if (event->button() != Qt::LeftButton)
+    return;
+  m_pressed = segmentAt(event->position().toPoint());
+  if (m_pressed != Segment::Count)
+    update(item(m_pressed).box);
+}
+
+void SegmentBar::mouseReleaseEvent(QMouseEvent *event) {
+  if (event->button() != Qt::LeftButton)
+    return;
+  Segment segment = segmentAt(event->position().toPoint());
+  Segment pressed = std::exchange(m_pressed, Segment::Count);
+  if (pressed != Segment::Count)
+    update(item(pressed).box);
+  if (segment != Segment::Count && segment == pressed)
+    emit clicked(segment);
+}
+
+void SegmentBar::leaveEvent(QEvent *event) {
+  QWidget::leaveEvent(event);
+  setHovered(Segment::Count);
+}
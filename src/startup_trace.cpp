@@ -0,0 +1,178 @@
+#include "startup_trace.hpp"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <print>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+struct Event {
+  const char *name;
+  char phase; // 'X' complete, 'i' instant
+  int64_t startUs;
+  int64_t durationUs;
+  pid_t tid;
+};
+
+struct Recorder {
+  std::mutex mutex;
+  std::vector<Event> events;
+  std::vector<std::pair<pid_t, QString>> threads;
+  QString path;
+  bool writeScheduled = false;
+};
+
+std::atomic<bool> g_enabled{false};
+
+Recorder &recorder() {
+  static Recorder instance;
+  return instance;
+}
+
+// Process start from /proc/self/stat field 22, in clock ticks since boot.
+int64_t processStartUs() {
+  std::ifstream stat("/proc/self/stat");
+  std::string line;
+  if (!std::getline(stat, line))
+    return -1;
+
+  // comm (field 2) may contain spaces; fields after it are space separated.
+  auto close = line.rfind(')');
+  if (close == std::string::npos)
+    return -1;
+  std::istringstream fields(line.substr(close + 2));
+  std::string field;
+  for (int i = 3; i <= 22 && fields >> field; ++i) {
+    if (i == 22)
+      return std::stoll(field) * 1'000'000 / sysconf(_SC_CLK_TCK);
+  }
+  return -1;
+}
+
+} // namespace
+
+void StartupTrace::enable(const QString &path) {
+  recorder().path = path;
+  g_enabled.store(true, std::memory_order_relaxed);
+
+  int64_t startUs = processStartUs();
+  if (startUs >= 0)
+    record("exec to main", 'X', startUs, nowUs() - startUs);
+}
+
+bool StartupTrace::enabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void StartupTrace::instant(const char *name) {
+  if (enabled())
+    record(name, 'i', nowUs(), 0);
+}
+
+void StartupTrace::firstFrame() {
+  if (!enabled())
+    return;
+  instant("first frame");
+
+  Recorder &r = recorder();
+  std::lock_guard lock(r.mutex);
+  if (r.writeScheduled)
+    return;
+  r.writeScheduled = true;
+  QTimer::singleShot(kSettleMs, QCoreApplication::instance(),
+                     &StartupTrace::write);
+}
+
+StartupTrace::Span::Span(const char *name) : m_name(name) {
+  if (enabled())
+    m_startUs = nowUs();
+}
+
+void StartupTrace::Span::end() {
+  if (m_startUs < 0)
+    return;
+  record(m_name, 'X', m_startUs, nowUs() - m_startUs);
+  m_startUs = -1;
+}
+
+int64_t StartupTrace::nowUs() {
+  timespec ts{};
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000;
+}
+
+void StartupTrace::record(const char *name, char phase, int64_t startUs,
+                          int64_t durationUs) {
+  pid_t tid = gettid();
+  Recorder &r = recorder();
+  std::lock_guard lock(r.mutex);
+  r.events.push_back({name, phase, startUs, durationUs, tid});
+
+  bool known = false;
+  for (const auto &thread : r.threads)
+    known = known || thread.first == tid;
+  if (!known) {
+    QString threadName = QThread::currentThread()->objectName();
+    if (threadName.isEmpty())
+      threadName = tid == getpid() ? "main" : QString::number(tid);
+    r.threads.emplace_back(tid, threadName);
+  }
+}
+
+void StartupTrace::write() {
+  Recorder &r = recorder();
+  std::lock_guard lock(r.mutex);
+
+  QJsonArray events;
+  for (const auto &[tid, name] : r.threads) {
+    events.append(QJsonObject{
+        {"name", "thread_name"},
+        {"ph", "M"},
+        {"pid", getpid()},
+        {"tid", tid},
+        {"args", QJsonObject{{"name", name}}},
+    });
+  }
+  for (const Event &e : r.events) {
+    QJsonObject event{
+        {"name", e.name},
+        {"cat", "startup"},
+        {"ph", QString(QChar(e.phase))},
+        {"ts", static_cast<qint64>(e.startUs)},
+        {"pid", getpid()},
+        {"tid", e.tid},
+    };
+    if (e.phase == 'X')
+      event.insert("dur", static_cast<qint64>(e.durationUs));
+    else
+      event.insert("s", "p"); // process-wide instant
+    events.append(event);
+  }
+
+  QFile file(r.path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Could not write startup trace" << r.path << ":"
+               << file.errorString();
+    return;
+  }
+  file.write(QJsonDocument(QJsonObject{{"traceEvents", events},
+                                       {"displayTimeUnit", "ms"}})
+                 .toJson(QJsonDocument::Compact));
+  std::println("Startup trace written to {}", r.path.toStdString());
+}
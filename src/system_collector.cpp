@@ -0,0 +1,252 @@
+#include "system_collector.hpp"
+
+#include "hyprland_ipc.hpp"
+#include "i3_ipc.hpp"
+#include "startup_trace.hpp"
+
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// True if something is accepting connections on the Unix socket at path.
+static bool probeSocket(const QString &path) {
+  QByteArray native = QFile::encodeName(path);
+  sockaddr_un addr{};
+  if (native.isEmpty() ||
+      static_cast<size_t>(native.size()) >= sizeof(addr.sun_path))
+    return false;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return false;
+
+  addr.sun_family = AF_UNIX;
+  std::copy(native.cbegin(), native.cend(), addr.sun_path);
+  bool ok = connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+  close(fd);
+  return ok;
+}
+
+// Last resort for sessions whose environment carries no hints: one pass over
+// /proc/*/comm, which is what pgrep would do, minus the fork/exec.
+static WindowManager scanProcesses() {
+  const QStringList pids =
+      QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+  for (const QString &pid : pids) {
+    if (!pid.front().isDigit())
+      continue;
+
+    QFile comm("/proc/" + pid + "/comm");
+    if (!comm.open(QIODevice::ReadOnly))
+      continue;
+    QByteArray name = comm.readLine().trimmed();
+
+    if (name == "Hyprland")
+      return WindowManager::Hyprland;
+    if (name == "sway")
+      return WindowManager::Sway;
+    if (name == "i3")
+      return WindowManager::I3;
+  }
+  return WindowManager::Other;
+}
+
+SystemCollector::SystemCollector(QObject *parent)
+    : QObject(parent), m_slots{std::make_shared<const SystemInfo>(),
+                               std::make_shared<const SystemInfo>()} {}
+
+std::shared_ptr<const SystemInfo> SystemCollector::snapshot() const {
+  // Registering before reading m_current keeps publish() off this slot until
+  // the copy is done. Sequentially consistent on purpose: the ordering
+  // between the two counters is what makes the handoff safe.
+  m_readers.fetch_add(1);
+  std::shared_ptr<const SystemInfo> info = m_slots[m_current.load()];
+  m_readers.fetch_sub(1);
+  return info;
+}
+
+void SystemCollector::acknowledge() {
+  m_notifyPending.store(false, std::memory_order_release);
+}
+
+void SystemCollector::start() {
+  StartupTrace::Span span("SystemCollector::start");
+  detectWindowManager();
+  setupSystemMonitoring();
+  setupWorkspaceMonitoring();
+}
+
+void SystemCollector::publish() {
+  ++m_info.generation;
+
+  // Readers that loaded the other slot before the last publish may still be
+  // copying it; they are gone within nanoseconds. Anyone arriving after this
+  // check reads m_current, which already points away from that slot.
+  int next = 1 - m_current.load();
+  while (m_readers.load() != 0)
+    std::this_thread::yield();
+  m_slots[next] = std::make_shared<const SystemInfo>(m_info);
+  m_current.store(next);
+
+  // Coalesce: while the reader has not caught up, it will find this snapshot
+  // anyway, so there is no point queueing another notification.
+  if (!m_notifyPending.exchange(true, std::memory_order_acq_rel))
+    emit published();
+}
+
+void SystemCollector::updateSystemInfo() {
+  updateCpuUsage();
+  updateMemoryUsage();
+  updateWorkspaceInfo();
+  publish();
+}
+
+void SystemCollector::detectWindowManager() {
+  // 1. A live IPC socket is the strongest signal and is what we connect to.
+  QString hyprDir = HyprlandIpc::socketDir();
+  if (!hyprDir.isEmpty() && probeSocket(hyprDir + "/.socket.sock")) {
+    m_info.windowManager = WindowManager::Hyprland;
+    return;
+  }
+  if (probeSocket(qEnvironmentVariable("SWAYSOCK"))) {
+    m_info.windowManager = WindowManager::Sway;
+    return;
+  }
+  if (probeSocket(qEnvironmentVariable("I3SOCK"))) {
+    m_info.windowManager = WindowManager::I3;
+    return;
+  }
+
+  // 2. Session hints, e.g. XDG_CURRENT_DESKTOP=sway or Hyprland
+  const QStringList desktops =
+      qEnvironmentVariable("XDG_CURRENT_DESKTOP").toLower().split(':');
+  for (const QString &desktop : desktops) {
+    if (desktop == "hyprland") {
+      m_info.windowManager = WindowManager::Hyprland;
+      return;
+    }
+    if (desktop == "sway") {
+      m_info.windowManager = WindowManager::Sway;
+      return;
+    }
+    if (desktop == "i3") {
+      m_info.windowManager = WindowManager::I3;
+      return;
+    }
+  }
+
+  // 3. Running processes
+  m_info.windowManager = scanProcesses();
+}
+
+void SystemCollector::redetectWindowManager() {
+  delete m_hyprland;
+  m_hyprland = nullptr;
+  delete m_i3;
+  m_i3 = nullptr;
+
+  detectWindowManager();
+  setupWorkspaceMonitoring();
+  updateWorkspaceInfo();
+  publish();
+}
+
+void SystemCollector::scheduleRedetect() {
+  // Back off so a session without a compositor is not probed every second.
+  QTimer::singleShot(m_redetectDelayMs, this,
+                     &SystemCollector::redetectWindowManager);
+  m_redetectDelayMs = std::min(m_redetectDelayMs * 2, kMaxRedetectMs);
+}
+
+void SystemCollector::setupSystemMonitoring() {
+  // Periodic samples are driven by SystemMonitor from the shared tick.
+  updateSystemInfo();
+}
+
+void SystemCollector::setupWorkspaceMonitoring() {
+  // Event-driven: changes are pushed as soon as the compositor reports them
+  if (m_info.windowManager == WindowManager::I3 ||
+      m_info.windowManager == WindowManager::Sway) {
+    m_i3 = new I3Ipc(this);
+    connect(m_i3, &I3Ipc::workspaceChanged, this,
+            &SystemCollector::onWorkspaceChanged);
+    connect(m_i3, &I3Ipc::activeWindowChanged, this,
+            &SystemCollector::onActiveWindowChanged);
+    connect(m_i3, &I3Ipc::connectionLost, this,
+            &SystemCollector::scheduleRedetect);
+    m_i3->start();
+  } else if (m_info.windowManager == WindowManager::Hyprland) {
+    m_hyprland = new HyprlandIpc(this);
+    connect(m_hyprland, &HyprlandIpc::workspaceChanged, this,
+            &SystemCollector::onWorkspaceChanged);
+    connect(m_hyprland, &HyprlandIpc::activeWindowChanged, this,
+            &SystemCollector::onActiveWindowChanged);
+    connect(m_hyprland, &HyprlandIpc::connectionLost, this,
+            &SystemCollector::scheduleRedetect);
+    m_hyprland->start();
+  }
+}
+
+void SystemCollector::onWorkspaceChanged(const QString &workspace) {
+  m_redetectDelayMs = kMinRedetectMs;
+  m_info.currentWorkspace = workspace;
+  publish();
+}
+
+void SystemCollector::onActiveWindowChanged(const QString &title) {
+  m_info.currentWindow = title.isEmpty() ? "Desktop" : title;
+  publish();
+}
+
+void SystemCollector::updateCpuUsage() {
+  if (!m_cpuSampler.sample())
+    return;
+
+  m_info.cpuUsage = m_cpuSampler.usage();
+  m_info.cpuSteal = m_cpuSampler.steal();
+  m_info.cpuGuest = m_cpuSampler.guest();
+
+  auto cores = m_cpuSampler.coreUsage();
+  m_info.coreUsage.resize(static_cast<qsizetype>(cores.size()));
+  std::copy(cores.begin(), cores.end(), m_info.coreUsage.begin());
+}
+
+void SystemCollector::updateMemoryUsage() {
+  if (!m_memSampler.sample())
+    return;
+
+  const MemInfo &mem = m_memSampler.info();
+  m_info.memInfo = mem;
+
+  auto memTotal = static_cast<double>(mem[MemKey::MemTotal]);
+  auto memAvailable = static_cast<double>(mem[MemKey::MemAvailable]);
+  auto swapTotal = static_cast<double>(mem[MemKey::SwapTotal]);
+  auto swapFree = static_cast<double>(mem[MemKey::SwapFree]);
+
+  if (memTotal > 0) {
+    m_info.memoryUsage = (memTotal - memAvailable) / memTotal * 100.0;
+  }
+
+  if (swapTotal > 0) {
+    m_info.swapUsage = (swapTotal - swapFree) / swapTotal * 100.0;
+  }
+}
+
+void SystemCollector::updateWorkspaceInfo() {
+  switch (m_info.windowManager) {
+  case WindowManager::I3:
+  case WindowManager::Sway:
+  case WindowManager::Hyprland:
+    break; // pushed by the IPC backends
+  default:
+    m_info.currentWorkspace = "Unknown WM";
+    m_info.currentWindow = "";
+    break;
+  }
+}
@@ -0,0 +1,89 @@
+#include "theme.hpp"
+
+#include "assets.hpp"
+#include "colors.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+
+static constexpr Theme::Palette kDefaultPalette = {
+    BASE_00, BASE_01, BASE_02, BASE_03, BASE_04, BASE_05, BASE_06, BASE_07,
+    BASE_08, BASE_09, BASE_0A, BASE_0B, BASE_0C, BASE_0D, BASE_0E, BASE_0F,
+};
+
+static constexpr const char *kColorNames[] = {
+    "base00", "base01", "base02", "base03", "base04", "base05",
+    "base06", "base07", "base08", "base09", "base0A", "base0B",
+    "base0C", "base0D", "base0E", "base0F",
+};
+static_assert(std::size(kColorNames) == static_cast<size_t>(Color::Count));
+
+// "base0d" or "base0D" -> index, -1 if it is not a palette name.
+static int colorIndex(QStringView name) {
+  for (size_t i = 0; i < std::size(kColorNames); ++i) {
+    if (name.compare(QLatin1StringView(kColorNames[i]), Qt::CaseInsensitive) ==
+        0)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+const Theme::Palette &Theme::palette() { return mutablePalette(); }
+
+Theme::Palette &Theme::mutablePalette() {
+  static Palette palette = loadPalette();
+  return palette;
+}
+
+bool Theme::reloadPalette() {
+  Palette loaded = loadPalette();
+  if (loaded == mutablePalette())
+    return false;
+  mutablePalette() = loaded;
+  return true;
+}
+
+Theme::Palette Theme::loadPalette() {
+  Palette palette = kDefaultPalette;
+
+  QFile file(QDir::homePath() + "/.config/stylix/palette.json");
+  if (!file.open(QIODevice::ReadOnly))
+    return palette;
+
+  QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+  for (auto it = object.begin(); it != object.end(); ++it) {
+    int index = colorIndex(it.key());
+    if (index < 0)
+      continue;
+
+    // stylix writes bare hex ("1a1b26"); accept "#1a1b26" as well
+    QString hex = it.value().toString();
+    if (!hex.startsWith('#'))
+      hex.prepend('#');
+    QColor parsed(hex);
+    if (parsed.isValid())
+      palette[static_cast<size_t>(index)] = parsed.rgb();
+  }
+  return palette;
+}
+
+QString Theme::stylesheet() {
+  static const QRegularExpression reference(R"(var\(--(base0[0-9A-Fa-f])\))");
+
+  QString source = QString::fromUtf8(Assets::read("style.css"));
+  QString result;
+  result.reserve(source.size());
+
+  qsizetype last = 0;
+  for (const QRegularExpressionMatch &match : reference.globalMatch(source)) {
+    result += QStringView(source).sliced(last, match.capturedStart() - last);
+    int index = colorIndex(match.capturedView(1));
+    result += QColor(palette()[static_cast<size_t>(index)]).name();
+    last = match.capturedEnd();
+  }
+  result += QStringView(source).sliced(last);
+  return result;
+}
@@ -0,0 +1,74 @@
+#include "theme_watcher.hpp"
+
+#include "assets.hpp"
+#include "theme.hpp"
+
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include <print>
+
+ThemeWatcher::ThemeWatcher(QObject *parent) : QObject(parent) {
+  m_applied = normalize(qApp->styleSheet());
+
+  m_debounce = new QTimer(this);
+  m_debounce->setSingleShot(true);
+  m_debounce->setInterval(kDebounceMs);
+  connect(m_debounce, &QTimer::timeout, this, &ThemeWatcher::reload);
+
+  m_watcher = new QFileSystemWatcher(this);
+  connect(m_watcher, &QFileSystemWatcher::fileChanged, m_debounce,
+          qOverload<>(&QTimer::start));
+  connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_debounce,
+          qOverload<>(&QTimer::start));
+  watchPaths();
+}
+
+void ThemeWatcher::watchPaths() {
+  // Editors often save by replacing the file, which drops the file watch,
+  // so the directories are watched too and files are re-added on reload.
+  // The bundled style.css is compiled in; only overrides can change.
+  QString overrides = Assets::overrideDir();
+  QStringList paths = {
+      QDir::homePath() + "/.config/stylix",
+      QDir::homePath() + "/.config/stylix/palette.json",
+      overrides,
+      overrides + "/style.css",
+  };
+
+  for (const QString &path : paths) {
+    if (QFileInfo::exists(path) && !m_watcher->files().contains(path) &&
+        !m_watcher->directories().contains(path))
+      m_watcher->addPath(path);
+  }
+}
+
+void ThemeWatcher::reload() {
+  QElapsedTimer timer;
+  timer.start();
+
+  bool paletteChanged = Theme::reloadPalette();
+  Assets::rescan(); // an override may have been added or removed
+  QString css = Theme::stylesheet();
+  watchPaths();
+
+  QString normalized = normalize(css);
+  if (normalized == m_applied)
+    return; // a save that changed nothing the style engine would see
+
+  qApp->setStyleSheet(css);
+  m_applied = normalized;
+  std::println("Reloaded stylesheet{} in {} ms",
+               paletteChanged ? " and palette" : "", timer.elapsed());
+}
+
+QString ThemeWatcher::normalize(const QString &css) {
+  static const QRegularExpression comments(
+      R"(/\*.*?\*/)", QRegularExpression::DotMatchesEverythingOption);
+  static const QRegularExpression whitespace(R"(\s+)");
+  return QString(css).remove(comments).replace(whitespace, " ").trimmed();
+}
@@ -0,0 +1,147 @@
+#include "tick_scheduler.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QEvent>
+
+#include <algorithm>
+#include <limits>
+
+TickScheduler *TickScheduler::instance() {
+  static auto *scheduler = new TickScheduler(QCoreApplication::instance());
+  return scheduler;
+}
+
+TickScheduler::TickScheduler(QObject *parent) : QObject(parent) {
+  m_timer = new QTimer(this);
+  m_timer->setSingleShot(true);
+  m_timer->setTimerType(Qt::PreciseTimer);
+  connect(m_timer, &QTimer::timeout, this, &TickScheduler::tick);
+  m_uptime.start();
+}
+
+int TickScheduler::add(const QString &name, int periodSec, int phaseSec,
+                       QObject *context, std::function<void()> fn,
+                       QWidget *visibleOnly) {
+  int id = m_nextId++;
+  Module module;
+  module.name = name;
+  module.period = std::max(periodSec, 1);
+  module.phase = phaseSec;
+  module.context = context;
+  module.fn = std::move(fn);
+  module.widget = visibleOnly;
+  module.visibleOnly = visibleOnly != nullptr;
+  module.dueSec = nextDue(module, QDateTime::currentSecsSinceEpoch());
+  m_modules.insert(id, std::move(module));
+
+  connect(context, &QObject::destroyed, this, [this, id] { remove(id); });
+  if (visibleOnly)
+    visibleOnly->installEventFilter(this);
+
+  reschedule();
+  return id;
+}
+
+void TickScheduler::remove(int id) {
+  if (m_modules.remove(id))
+    reschedule();
+}
+
+QStringList TickScheduler::stats() const {
+  double minutes = std::max(static_cast<double>(m_uptime.elapsed()), 1.0) /
+                   60'000.0;
+  QStringList lines;
+  for (const Module &module : m_modules) {
+    lines << QString("%1 (every %2s): %3/min")
+                 .arg(module.name)
+                 .arg(module.period)
+                 .arg(static_cast<double>(module.runs) / minutes, 0, 'f', 1);
+  }
+  lines << QString("Total: %1/min")
+               .arg(static_cast<double>(m_wakeups) / minutes, 0, 'f', 1);
+  return lines;
+}
+
+bool TickScheduler::eventFilter(QObject *watched, QEvent *event) {
+  if (event->type() == QEvent::Show || event->type() == QEvent::Hide) {
+    if (event->type() == QEvent::Show) {
+      // Whatever it shows is stale; catch up on the next event loop pass.
+      qint64 now = QDateTime::currentSecsSinceEpoch();
+      for (Module &module : m_modules) {
+        if (module.widget == watched)
+          module.dueSec = now;
+      }
+    }
+    reschedule();
+  }
+  return QObject::eventFilter(watched, event);
+}
+
+void TickScheduler::tick() {
+  ++m_wakeups;
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+
+  // Callbacks may add or remove modules, so collect the due ones first.
+  QList<int> due;
+  for (auto it = m_modules.cbegin(); it != m_modules.cend(); ++it) {
+    if (it->dueSec <= now && isActive(*it))
+      due << it.key();
+  }
+
+  for (int id : due) {
+    auto it = m_modules.find(id);
+    if (it == m_modules.end())
+      continue;
+    it->dueSec = nextDue(*it, now);
+    ++it->runs;
+    std::function<void()> fn = it->fn;
+    fn();
+  }
+
+  reschedule();
+}
+
+void TickScheduler::reschedule() {
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+  qint64 next = std::numeric_limits<qint64>::max();
+  int shortestPeriod = std::numeric_limits<int>::max();
+  for (Module &module : m_modules) {
+    if (!isActive(module))
+      continue;
+    // Due more than a period ahead means the wall clock stepped back;
+    // realign instead of sleeping through the step.
+    if (module.dueSec > now + module.period)
+      module.dueSec = nextDue(module, now);
+    next = std::min(next, module.dueSec);
+    shortestPeriod = std::min(shortestPeriod, module.period);
+  }
+
+  if (next == std::numeric_limits<qint64>::max()) {
+    m_timer->stop(); // everything is suspended: no wakeups at all
+    return;
+  }
+
+  // The timer is monotonic but boundaries are wall-clock. Never sleep longer
+  // than one period, so a backward step while armed is caught on waking.
+  qint64 delayMs =
+      next * 1000 + kSlackMs - QDateTime::currentMSecsSinceEpoch();
+  delayMs = std::clamp<qint64>(delayMs, 0,
+                               qint64{shortestPeriod} * 1000 + kSlackMs);
+  m_timer->start(static_cast<int>(delayMs));
+}
+
+bool TickScheduler::isActive(const Module &module) {
+  if (!module.context)
+    return false;
+  if (!module.visibleOnly)
+    return true;
+  return module.widget && module.widget->isVisible();
+}
+
+qint64 TickScheduler::nextDue(const Module &module, qint64 afterSec) {
+  qint64 offset = (afterSec - module.phase) % module.period;
+  if (offset < 0)
+    offset += module.period;
+  return afterSec + (module.period - offset);
+}
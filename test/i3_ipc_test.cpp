@@ -0,0 +1,146 @@
+// Runs I3Ipc against a stand-in i3 socket server. The server answers with
+// frames split inside the magic, the header and the payload, and with
+// several frames per write, and mixes in a reply that looks like an event
+// but lacks the event bit. Exits non-zero unless the workspace and title
+// changes I3Ipc reports are exactly the expected ones.
+
+#include "i3_ipc.hpp"
+
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QStringList>
+#include <QTimer>
+
+#include <cstdint>
+#include <print>
+
+namespace {
+
+constexpr uint32_t kEventBit = 0x80000000;
+
+QByteArray frame(uint32_t type, const QByteArray &payload) {
+  auto length = static_cast<uint32_t>(payload.size());
+  QByteArray message("i3-ipc");
+  message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  message.append(reinterpret_cast<const char *>(&type), sizeof(type));
+  message.append(payload);
+  return message;
+}
+
+// Replies to SUBSCRIBE, GET_WORKSPACES and GET_TREE, then events.
+QList<QByteArray> frames() {
+  return {
+      frame(2, R"({"success":true})"),
+      frame(1, R"([{"name":"1","focused":false},)"
+               R"({"name":"2: web","focused":true}])"),
+      frame(4, R"({"type":"root","name":"root","focused":false,"nodes":[)"
+               R"({"type":"workspace","name":"2: web","focused":false,)"
+               R"("nodes":[{"type":"con","name":"Tree title","focused":true,)"
+               R"("nodes":[],"floating_nodes":[]}],"floating_nodes":[]}],)"
+               R"("floating_nodes":[]})"),
+      // RUN_COMMAND reply: type 0 without the event bit is not a
+      // workspace event, whatever the payload says.
+      frame(0, R"({"change":"focus","current":{"name":"wrong"}})"),
+      frame(kEventBit | 0,
+            R"({"change":"focus","current":{"type":"workspace","name":"3",)"
+            R"("focused":true,"nodes":[{"type":"con","name":"Editor",)"
+            R"("focused":true,"nodes":[],"floating_nodes":[]}],)"
+            R"("floating_nodes":[]}})"),
+      frame(kEventBit | 3, R"({"change":"title","container":)"
+                           R"({"name":"Editor - saved","focused":true}})"),
+      frame(kEventBit | 2, R"({"change":"resize"})"), // not subscribed
+  };
+}
+
+// The stream cut at awkward offsets; each piece is one write.
+QList<QByteArray> chunks(const QList<QByteArray> &parts) {
+  QByteArray stream = parts.join();
+  qsizetype threeFrames = parts[0].size() + parts[1].size() + parts[2].size();
+  QList<qsizetype> cuts = {
+      3,                    // inside the magic
+      8,                    // inside the length
+      parts[0].size() + 20, // inside the second payload
+      threeFrames + 7,      // rest of the tree plus part of a header
+      stream.size() - 5,    // four frames at once, minus a tail
+      stream.size(),
+  };
+
+  QList<QByteArray> result;
+  qsizetype from = 0;
+  for (qsizetype cut : cuts) {
+    result << stream.mid(from, cut - from);
+    from = cut;
+  }
+  return result;
+}
+
+bool expect(const char *what, const QStringList &got,
+            const QStringList &want) {
+  if (got == want)
+    return true;
+  std::println(stderr, "{}: got [{}], want [{}]", what,
+               got.join(", ").toStdString(), want.join(", ").toStdString());
+  return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QString name =
+      QString("obolc-i3-ipc-test-%1").arg(QCoreApplication::applicationPid());
+  QLocalServer::removeServer(name);
+  QLocalServer server;
+  if (!server.listen(name)) {
+    std::println(stderr, "listen: {}", server.errorString().toStdString());
+    return 1;
+  }
+
+  // Each chunk goes out on its own event loop pass, so the client sees
+  // separate reads.
+  QList<QByteArray> pending = chunks(frames());
+  QObject::connect(&server, &QLocalServer::newConnection, &app, [&] {
+    QLocalSocket *client = server.nextPendingConnection();
+    auto *writer = new QTimer(client);
+    writer->setInterval(20);
+    QObject::connect(writer, &QTimer::timeout, client, [&, client, writer] {
+      if (pending.isEmpty()) {
+        writer->stop();
+        QTimer::singleShot(100, &app, &QCoreApplication::quit);
+        return;
+      }
+      client->write(pending.takeFirst());
+      client->flush();
+    });
+    writer->start();
+  });
+
+  QStringList workspaces;
+  QStringList titles;
+  I3Ipc ipc;
+  QObject::connect(&ipc, &I3Ipc::workspaceChanged,
+                   [&](const QString &workspace) { workspaces << workspace; });
+  QObject::connect(&ipc, &I3Ipc::activeWindowChanged,
+                   [&](const QString &title) { titles << title; });
+  ipc.start(server.fullServerName());
+
+  bool timedOut = false;
+  QTimer::singleShot(5000, &app, [&] {
+    timedOut = true;
+    app.quit();
+  });
+  app.exec();
+
+  if (timedOut || !pending.isEmpty()) {
+    std::println(stderr, "timed out with {} chunks unsent", pending.size());
+    return 1;
+  }
+  bool ok = expect("workspaces", workspaces, {"2: web", "3"});
+  ok = expect("titles", titles, {"Tree title", "Editor", "Editor - saved"}) &&
+       ok;
+  if (ok)
+    std::println("i3-ipc framing: ok");
+  return ok ? 0 : 1;
+}